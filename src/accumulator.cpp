@@ -0,0 +1,112 @@
+#include "accumulator.h"
+
+Accumulator::Accumulator(const NeuralNetwork& network)
+    : network(network), top(0), updates(0), refreshes(0) {
+}
+
+void Accumulator::compute(const Board& board, Ply& ply) {
+    refreshes++;
+    ply.preActivations = network.firstLayerBiases();
+    ply.pieces = board._pieces;
+    
+    // Only the pieces on the board contribute, so add their columns rather than the full product
+    for (int color = WHITE; color <= BLACK; color++) {
+        for (int piece = PAWN; piece <= KING; piece++) {
+            Bitboard pieces = board._pieces[color][piece];
+            while (pieces) {
+                Square sq = BitboardUtils::lsb(pieces);
+                pieces &= pieces - 1;
+                size_t index = BoardFeatureExtractor::pieceFeatureIndex(sq, PieceType(piece), Color(color));
+                network.addFirstLayerColumn(ply.preActivations, index, 1.0f);
+            }
+        }
+    }
+    
+    BoardFeatureExtractor::extractStateFeatures(board, ply.state.data());
+    for (size_t i = 0; i < ply.state.size(); i++) {
+        if (ply.state[i] != 0.0f) {
+            network.addFirstLayerColumn(ply.preActivations, BoardFeatureExtractor::NUM_PIECE_FEATURES + i, ply.state[i]);
+        }
+    }
+}
+
+void Accumulator::refresh(const Board& board) {
+    if (top == 0) {
+        top = 1;
+    }
+    if (plies.size() < top) {
+        plies.resize(top);
+    }
+    compute(board, plies[top - 1]);
+}
+
+void Accumulator::push(const Board& board) {
+    if (top == 0) {
+        refresh(board);
+        return;
+    }
+    
+    if (plies.size() <= top) {
+        plies.resize(top + 1);
+    }
+    const Ply& previous = plies[top - 1];
+    Ply& current = plies[top];
+    top++;
+    
+    // A move changes at most four piece features (castling), anything more means an unrelated position
+    int changed = 0;
+    for (int color = WHITE; color <= BLACK; color++) {
+        for (int piece = PAWN; piece <= KING; piece++) {
+            changed += BitboardUtils::popCount(previous.pieces[color][piece] ^ board._pieces[color][piece]);
+        }
+    }
+    if (changed > ACCUMULATOR_REFRESH_THRESHOLD) {
+        compute(board, current);
+        return;
+    }
+    
+    updates++;
+    current.preActivations = previous.preActivations;
+    current.pieces = board._pieces;
+    for (int color = WHITE; color <= BLACK; color++) {
+        for (int piece = PAWN; piece <= KING; piece++) {
+            Bitboard before = previous.pieces[color][piece];
+            Bitboard after = board._pieces[color][piece];
+            
+            Bitboard removed = before & ~after;
+            while (removed) {
+                Square sq = BitboardUtils::lsb(removed);
+                removed &= removed - 1;
+                size_t index = BoardFeatureExtractor::pieceFeatureIndex(sq, PieceType(piece), Color(color));
+                network.addFirstLayerColumn(current.preActivations, index, -1.0f);
+            }
+            
+            Bitboard added = after & ~before;
+            while (added) {
+                Square sq = BitboardUtils::lsb(added);
+                added &= added - 1;
+                size_t index = BoardFeatureExtractor::pieceFeatureIndex(sq, PieceType(piece), Color(color));
+                network.addFirstLayerColumn(current.preActivations, index, 1.0f);
+            }
+        }
+    }
+    
+    // Side to move, castling, en passant, clock and check features
+    BoardFeatureExtractor::extractStateFeatures(board, current.state.data());
+    for (size_t i = 0; i < current.state.size(); i++) {
+        float delta = current.state[i] - previous.state[i];
+        if (delta != 0.0f) {
+            network.addFirstLayerColumn(current.preActivations, BoardFeatureExtractor::NUM_PIECE_FEATURES + i, delta);
+        }
+    }
+}
+
+void Accumulator::pop() {
+    if (top > 1) {
+        top--;
+    }
+}
+
+float Accumulator::evaluate() const {
+    return network.evaluateFromFirstLayer(preActivations());
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include "board.h"
+#include "neural_network.h"
+#include "feature_extractor.h"
+
+// Positions whose piece features differ by more than this from the previous ply are refreshed from scratch
+constexpr int ACCUMULATOR_REFRESH_THRESHOLD = 16;
+
+// NNUE-style accumulator: the value network's first-layer pre-activations for each ply
+// of a line of play. Making a move only adds or subtracts the weight columns of the
+// few features that changed, instead of redoing the whole first-layer product.
+//
+// The board is copy-make, so the accumulator mirrors it with a stack: push() after
+// makeMove, pop() in place of an unmake. Whenever the network's weights change the
+// accumulator has to be refreshed.
+class Accumulator {
+public:
+    explicit Accumulator(const NeuralNetwork& network);
+
+    // Recompute the pre-activations of the current ply from scratch (starts a new line on an empty stack)
+    void refresh(const Board& board);
+
+    // Add a ply for the board reached by a move from the current ply, updated incrementally
+    void push(const Board& board);
+
+    // Go back to the previous ply (the first ply stays until the next refresh)
+    void pop();
+
+    // Value of the current ply's position from White's perspective
+    float evaluate() const;
+
+    // Number of plies on the stack
+    size_t size() const { return top; }
+
+    // First-layer pre-activations of the current ply (after at least one refresh or push)
+    const std::vector<float>& preActivations() const { return plies[top - 1].preActivations; }
+
+    // Statistics: incremental updates and full refreshes so far
+    uint64_t updateCount() const { return updates; }
+    uint64_t refreshCount() const { return refreshes; }
+
+private:
+    // Everything needed to update the next ply from this one
+    struct Ply {
+        std::vector<float> preActivations;
+        std::array<std::array<Bitboard, 6>, 2> pieces;
+        std::array<float, BoardFeatureExtractor::NUM_STATE_FEATURES> state;
+    };
+
+    // Fill a ply from scratch
+    void compute(const Board& board, Ply& ply);
+
+    const NeuralNetwork& network;
+    std::vector<Ply> plies;
+    size_t top;
+
+    uint64_t updates;
+    uint64_t refreshes;
+};
@@ -0,0 +1,101 @@
+#include "batch_evaluator.h"
+#include "feature_extractor.h"
+#include <algorithm>
+
+BatchEvaluator::BatchEvaluator(std::shared_ptr<const NeuralNetwork> network, size_t batchSize,
+                               std::chrono::microseconds maxLatency)
+    : network(network), maxBatchSize(std::max<size_t>(batchSize, 1)), maxLatency(maxLatency),
+      stopping(false), batches(0), positions(0) {
+    thread = std::thread(&BatchEvaluator::run, this);
+}
+
+BatchEvaluator::~BatchEvaluator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    queued.notify_one();
+    thread.join();
+}
+
+float BatchEvaluator::evaluate(const Board& board) {
+    // Feature extraction runs on the caller's thread, only the forward pass is batched
+    Request request;
+    request.features = BoardFeatureExtractor::extractFeatures(board);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (pending.empty()) {
+        oldestArrival = std::chrono::steady_clock::now();
+    }
+    pending.push_back(&request);
+
+    // Wake the evaluation thread to start the latency clock, or to run a full batch
+    if (pending.size() == 1 || pending.size() >= maxBatchSize) {
+        queued.notify_one();
+    }
+
+    evaluated.wait(lock, [&request]() { return request.done; });
+
+    // The network scores positions from White's perspective
+    return board.sideToMove() == WHITE ? request.value : -request.value;
+}
+
+uint64_t BatchEvaluator::batchCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return batches;
+}
+
+uint64_t BatchEvaluator::positionCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return positions;
+}
+
+void BatchEvaluator::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        // Wait for a full batch, or flush a partial one once its oldest request is due
+        if (pending.empty()) {
+            queued.wait(lock, [this]() { return stopping || !pending.empty(); });
+        } else if (pending.size() < maxBatchSize) {
+            queued.wait_until(lock, oldestArrival + maxLatency,
+                              [this]() { return stopping || pending.size() >= maxBatchSize; });
+        }
+
+        if (pending.empty()) {
+            if (stopping) {
+                return;
+            }
+            continue;
+        }
+        if (pending.size() < maxBatchSize && !stopping &&
+            std::chrono::steady_clock::now() < oldestArrival + maxLatency) {
+            continue;
+        }
+
+        // Take up to one batch and evaluate it without holding the lock
+        size_t count = std::min(pending.size(), maxBatchSize);
+        std::vector<Request*> batch(pending.begin(), pending.begin() + count);
+        pending.erase(pending.begin(), pending.begin() + count);
+        if (!pending.empty()) {
+            oldestArrival = std::chrono::steady_clock::now();
+        }
+        lock.unlock();
+
+        std::vector<std::vector<float>> inputs;
+        inputs.reserve(count);
+        for (Request* request : batch) {
+            inputs.push_back(std::move(request->features));
+        }
+        std::vector<float> values = network->evaluateBatch(inputs);
+
+        lock.lock();
+        for (size_t i = 0; i < count; i++) {
+            batch[i]->value = values[i];
+            batch[i]->done = true;
+        }
+        batches++;
+        positions += count;
+        evaluated.notify_all();
+    }
+}
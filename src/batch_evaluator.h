@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include "board.h"
+#include "neural_network.h"
+
+// Default number of positions evaluated per forward pass
+constexpr size_t DEFAULT_EVAL_BATCH_SIZE = 8;
+
+// Default time a queued position waits for the batch to fill up
+constexpr int64_t DEFAULT_EVAL_BATCH_LATENCY_US = 1000;
+
+// Collects positions from many search threads and evaluates them with one
+// batched forward pass. Callers block until their batch has been evaluated.
+class BatchEvaluator {
+public:
+    BatchEvaluator(std::shared_ptr<const NeuralNetwork> network,
+                   size_t batchSize = DEFAULT_EVAL_BATCH_SIZE,
+                   std::chrono::microseconds maxLatency = std::chrono::microseconds(DEFAULT_EVAL_BATCH_LATENCY_US));
+
+    // Stops the evaluation thread (no caller may be waiting)
+    ~BatchEvaluator();
+
+    BatchEvaluator(const BatchEvaluator&) = delete;
+    BatchEvaluator& operator=(const BatchEvaluator&) = delete;
+
+    // Value of a position from the side to move's point of view (thread-safe, blocking)
+    float evaluate(const Board& board);
+
+    // Number of forward passes and positions evaluated so far
+    uint64_t batchCount() const;
+    uint64_t positionCount() const;
+
+    // Maximum number of positions per forward pass
+    size_t batchSize() const { return maxBatchSize; }
+
+private:
+    // A queued position, owned by the waiting caller
+    struct Request {
+        std::vector<float> features;
+        float value = 0.0f;
+        bool done = false;
+    };
+
+    // Evaluation thread: waits for a full batch or the latency deadline, then runs it
+    void run();
+
+    std::shared_ptr<const NeuralNetwork> network;
+    size_t maxBatchSize;
+    std::chrono::microseconds maxLatency;
+
+    // Queue of pending requests and the time the oldest one arrived
+    mutable std::mutex mutex;
+    std::condition_variable queued;
+    std::condition_variable evaluated;
+    std::vector<Request*> pending;
+    std::chrono::steady_clock::time_point oldestArrival;
+    bool stopping;
+
+    // Statistics
+    uint64_t batches;
+    uint64_t positions;
+
+    std::thread thread;
+};
@@ -0,0 +1,176 @@
+#include "batch_protocol.h"
+#include "feature_extractor.h"
+#include <cstring>
+#include <limits>
+
+namespace {
+    // Value of a position whose side to move has been mated, on the scale of the training rewards
+    constexpr float MATED_VALUE = -1.0f;
+}
+
+BatchProtocol::BatchProtocol(const NeuralNetwork& network, ProtocolResult result, size_t batchSize)
+    : network(network), result(result), maxBatchSize(batchSize > 0 ? batchSize : 1), batches(0) {
+    input.resize(maxBatchSize * PACKED_BOARD_SIZE);
+    boards.resize(maxBatchSize);
+    output.reserve(maxBatchSize * resultSize(result));
+}
+
+size_t BatchProtocol::resultSize(ProtocolResult result) {
+    return result == ProtocolResult::Value ? sizeof(float) : sizeof(uint16_t) + sizeof(float);
+}
+
+uint64_t BatchProtocol::run(std::istream& in, std::ostream& out) {
+    uint64_t answered = 0;
+    while (size_t count = readBatch(in)) {
+        output.clear();
+        if (result == ProtocolResult::Value) {
+            answerValues(count);
+        } else {
+            answerMoves(count);
+        }
+
+        // One write per batch, flushed so the client can read its results right away
+        out.write(reinterpret_cast<const char*>(output.data()), static_cast<std::streamsize>(output.size()));
+        out.flush();
+        if (!out) {
+            break;
+        }
+
+        answered += count;
+        batches++;
+    }
+    return answered;
+}
+
+size_t BatchProtocol::readBatch(std::istream& in) {
+    std::streambuf* buffer = in.rdbuf();
+    const std::streamsize size = static_cast<std::streamsize>(PACKED_BOARD_SIZE);
+
+    size_t count = 0;
+    while (count < maxBatchSize) {
+        // Past the first position, don't wait for positions the client hasn't sent yet
+        if (count > 0 && buffer->in_avail() < size) {
+            break;
+        }
+        char* position = reinterpret_cast<char*>(input.data() + count * PACKED_BOARD_SIZE);
+        if (buffer->sgetn(position, size) < size) {
+            break;
+        }
+        count++;
+    }
+    return count;
+}
+
+void BatchProtocol::answerValues(size_t count) {
+    const size_t size = BoardFeatureExtractor::getFeatureSize();
+    std::vector<bool> valid(count);
+    size_t rows = 0;
+
+    features.resize(count * size);
+    for (size_t i = 0; i < count; i++) {
+        valid[i] = boards[i].unpack(input.data() + i * PACKED_BOARD_SIZE);
+        if (valid[i]) {
+            BoardFeatureExtractor::extractFeatures(boards[i], features.data() + rows * size);
+            rows++;
+        }
+    }
+
+    values.resize(rows);
+    network.evaluateBatch(features.data(), rows, values.data());
+
+    size_t row = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!valid[i]) {
+            writeValue(std::numeric_limits<float>::quiet_NaN());
+            continue;
+        }
+        // The network scores positions from White's perspective
+        float value = values[row++];
+        writeValue(boards[i].sideToMove() == WHITE ? value : -value);
+    }
+}
+
+void BatchProtocol::answerMoves(size_t count) {
+    // A legal move of a batch position, with its value if it ends the game
+    struct Candidate {
+        Move move;
+        bool mates;
+    };
+
+    const size_t size = BoardFeatureExtractor::getFeatureSize();
+    std::vector<bool> valid(count);
+    std::vector<Candidate> candidates;
+    std::vector<size_t> firstCandidate(count + 1);
+    size_t rows = 0;
+
+    // The children of every position go through one forward pass
+    features.clear();
+    for (size_t i = 0; i < count; i++) {
+        firstCandidate[i] = candidates.size();
+        valid[i] = boards[i].unpack(input.data() + i * PACKED_BOARD_SIZE);
+        if (!valid[i]) {
+            continue;
+        }
+
+        for (const Move& move : boards[i].generateLegalMoves()) {
+            Board child = boards[i];
+            child.makeMove(move);
+            bool mates = child.isCheckmate();
+            candidates.push_back({move, mates});
+            if (!mates) {
+                features.resize((rows + 1) * size);
+                BoardFeatureExtractor::extractFeatures(child, features.data() + rows * size);
+                rows++;
+            }
+        }
+    }
+    firstCandidate[count] = candidates.size();
+
+    values.resize(rows);
+    network.evaluateBatch(features.data(), rows, values.data());
+
+    size_t row = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!valid[i]) {
+            writeMove(0);
+            writeValue(std::numeric_limits<float>::quiet_NaN());
+            continue;
+        }
+
+        Move bestMove;
+        float bestValue = -std::numeric_limits<float>::infinity();
+        for (size_t c = firstCandidate[i]; c < firstCandidate[i + 1]; c++) {
+            float value = -MATED_VALUE;
+            if (!candidates[c].mates) {
+                // Children are scored from White's perspective, turn it into the mover's
+                value = boards[i].sideToMove() == WHITE ? values[row] : -values[row];
+                row++;
+            }
+            if (value > bestValue) {
+                bestValue = value;
+                bestMove = candidates[c].move;
+            }
+        }
+
+        // Without a legal move the game is over
+        if (!bestMove.isValid()) {
+            bestValue = boards[i].isCheckmate() ? MATED_VALUE : 0.0f;
+        }
+
+        writeMove(bestMove.pack());
+        writeValue(bestValue);
+    }
+}
+
+void BatchProtocol::writeValue(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; i++) {
+        output.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+    }
+}
+
+void BatchProtocol::writeMove(uint16_t move) {
+    output.push_back(static_cast<uint8_t>(move & 0xFF));
+    output.push_back(static_cast<uint8_t>(move >> 8));
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include "board.h"
+#include "neural_network.h"
+
+// Most positions evaluated per forward pass
+constexpr size_t DEFAULT_PROTOCOL_BATCH_SIZE = 256;
+
+// Result written for each position, little endian
+enum class ProtocolResult {
+    // 4 bytes: network value (float) for the side to move
+    Value,
+
+    // 6 bytes: best move of a one-ply network search (packed, 0 if there is none),
+    // then its value (float) for the side to move
+    MoveAndScore
+};
+
+// Binary protocol for scoring large position sets with the value network. The
+// client streams positions packed in PACKED_BOARD_SIZE bytes (see Board::pack)
+// and gets one fixed-size result per position, in input order. Each batch takes
+// the positions that have already arrived, so a client waiting for its results
+// before sending more is answered. Invalid positions get a NaN value and no move.
+class BatchProtocol {
+public:
+    BatchProtocol(const NeuralNetwork& network, ProtocolResult result,
+                  size_t batchSize = DEFAULT_PROTOCOL_BATCH_SIZE);
+
+    // Answer positions until the input ends (a trailing partial position is
+    // ignored); returns the number of positions answered
+    uint64_t run(std::istream& in, std::ostream& out);
+
+    // Bytes written for each position
+    static size_t resultSize(ProtocolResult result);
+
+    // Number of batches answered so far
+    uint64_t batchCount() const { return batches; }
+
+private:
+    // Read up to a batch of positions into the input buffer, blocking only for the first one
+    size_t readBatch(std::istream& in);
+
+    // Evaluate the positions read and append their results to the output buffer
+    void answerValues(size_t count);
+    void answerMoves(size_t count);
+
+    // Append a little-endian value to the output buffer
+    void writeValue(float value);
+    void writeMove(uint16_t move);
+
+    const NeuralNetwork& network;
+    ProtocolResult result;
+    size_t maxBatchSize;
+
+    // Buffers reused from batch to batch
+    std::vector<uint8_t> input;
+    std::vector<Board> boards;
+    std::vector<float> features;
+    std::vector<float> values;
+    std::vector<uint8_t> output;
+
+    uint64_t batches;
+};
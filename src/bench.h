@@ -0,0 +1,40 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "search.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+// Depth every bench position is searched to
+constexpr int DEFAULT_BENCH_DEPTH = 8;
+
+// Transposition table size of the bench search (cleared before each position)
+constexpr size_t DEFAULT_BENCH_HASH_MB = 16;
+
+// Totals of a bench run
+struct BenchResult {
+    int positions = 0;
+    uint64_t nodes = 0;
+    int64_t timeMs = 0;
+
+    // Nodes per second over the whole run
+    uint64_t nps() const { return nodes * 1000 / static_cast<uint64_t>(timeMs > 0 ? timeMs : 1); }
+};
+
+// Function type for receiving the result of each bench position
+using BenchCallback = std::function<void(size_t index, const std::string& fen, const SearchResult& result)>;
+
+// Fixed-depth searches of a built-in position set. The total node count is a
+// signature of the search: it only changes when the search behaves differently,
+// while the nodes per second compare builds and machines.
+namespace Bench {
+    // The built-in positions as FEN strings
+    const std::vector<std::string>& positions();
+
+    // Search every position to the depth with default options, a fresh table and
+    // no bitbases, so the node count doesn't depend on anything but the code
+    BenchResult run(int depth = DEFAULT_BENCH_DEPTH, const BenchCallback& callback = nullptr);
+}
+
+#endif // BENCH_H
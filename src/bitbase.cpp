@@ -0,0 +1,652 @@
+#include "bitbase.h"
+#include "movegen.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    using Bitbases::Ending;
+    using Bitbases::WDL;
+
+    // Largest ending the tables are laid out for, kings included
+    constexpr int MAX_PIECES = 4;
+
+    // Values stored in a table, 2 bits each, from the side to move's point of view
+    constexpr uint8_t INVALID = 0;
+    constexpr uint8_t LOST = 1;
+    constexpr uint8_t DRAWN = 2;
+    constexpr uint8_t WON = 3;
+
+    // Positions not decided yet while generating
+    constexpr uint8_t UNKNOWN = 4;
+
+    // Flag next to the move count of an undecided position that can convert into a draw
+    constexpr uint8_t DRAW_EXIT = 0x80;
+
+    // Table files: header, then the packed values
+    constexpr uint32_t FILE_MAGIC = 0x42424342; // "BCBB"
+    constexpr uint32_t FILE_VERSION = 1;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t positions;
+    };
+
+    Color opposite(Color color) {
+        return Color(1 - color);
+    }
+
+    // The pieces of a small ending, the white king first and the black king second
+    struct Placement {
+        int count = 0;
+        Square squares[MAX_PIECES];
+        PieceType types[MAX_PIECES];
+        Color colors[MAX_PIECES];
+        Color sideToMove = WHITE;
+
+        Bitboard occupied() const {
+            Bitboard bb = 0;
+            for (int i = 0; i < count; ++i) {
+                bb |= 1ULL << squares[i];
+            }
+            return bb;
+        }
+
+        Bitboard pieces(Color color) const {
+            Bitboard bb = 0;
+            for (int i = 0; i < count; ++i) {
+                if (colors[i] == color) {
+                    bb |= 1ULL << squares[i];
+                }
+            }
+            return bb;
+        }
+
+        Square king(Color color) const {
+            return squares[color == WHITE ? 0 : 1];
+        }
+
+        // Index of the piece on a square (-1 if empty)
+        int pieceOn(Square sq) const {
+            for (int i = 0; i < count; ++i) {
+                if (squares[i] == sq) {
+                    return i;
+                }
+            }
+            return -1;
+        }
+
+        // Take a piece off the board, keeping the order of the others
+        void remove(int index) {
+            for (int i = index; i < count - 1; ++i) {
+                squares[i] = squares[i + 1];
+                types[i] = types[i + 1];
+                colors[i] = colors[i + 1];
+            }
+            count--;
+        }
+    };
+
+    // Piece counts of one side besides the king, packed four bits per piece type
+    int materialKey(const std::vector<PieceType>& pieces) {
+        int key = 0;
+        for (PieceType piece : pieces) {
+            key += 1 << (4 * piece);
+        }
+        return key;
+    }
+
+    int materialKey(const Placement& placement, Color color) {
+        int key = 0;
+        for (int i = 0; i < placement.count; ++i) {
+            if (placement.colors[i] == color && placement.types[i] != KING) {
+                key += 1 << (4 * placement.types[i]);
+            }
+        }
+        return key;
+    }
+
+    // Pieces of an ending as they are laid out in its table, with the stronger side as White
+    Placement layout(const Ending& ending) {
+        Placement placement;
+        placement.types[0] = KING;
+        placement.colors[0] = WHITE;
+        placement.types[1] = KING;
+        placement.colors[1] = BLACK;
+        placement.count = 2;
+        for (PieceType piece : ending.strong) {
+            placement.types[placement.count] = piece;
+            placement.colors[placement.count++] = WHITE;
+        }
+        for (PieceType piece : ending.weak) {
+            placement.types[placement.count] = piece;
+            placement.colors[placement.count++] = BLACK;
+        }
+        for (int i = 0; i < placement.count; ++i) {
+            placement.squares[i] = A1;
+        }
+        return placement;
+    }
+
+    // Position index: the side to move, then six bits per piece in layout order
+    size_t indexOf(const Placement& placement) {
+        size_t index = 0;
+        for (int i = placement.count - 1; i >= 0; --i) {
+            index = index * 64 + placement.squares[i];
+        }
+        return index * 2 + placement.sideToMove;
+    }
+
+    void decode(size_t index, Placement& placement) {
+        placement.sideToMove = Color(index & 1);
+        index >>= 1;
+        for (int i = 0; i < placement.count; ++i) {
+            placement.squares[i] = static_cast<Square>(index & 63);
+            index >>= 6;
+        }
+    }
+
+    // Check if a square is attacked by a color's pieces
+    bool attacked(const Placement& placement, Square sq, Color by) {
+        Bitboard occupied = placement.occupied();
+        for (int i = 0; i < placement.count; ++i) {
+            if (placement.colors[i] == by &&
+                (MoveGenerator::getPieceAttacks(placement.types[i], placement.squares[i], by, occupied) & (1ULL << sq))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool inCheck(const Placement& placement) {
+        return attacked(placement, placement.king(placement.sideToMove), opposite(placement.sideToMove));
+    }
+
+    // Pieces on distinct squares, no pawn on the first or last rank, and the side
+    // that just moved not left in check
+    bool isValid(const Placement& placement) {
+        if (BitboardUtils::popCount(placement.occupied()) != placement.count) {
+            return false;
+        }
+        for (int i = 0; i < placement.count; ++i) {
+            int rank = BitboardUtils::squareRank(placement.squares[i]);
+            if (placement.types[i] == PAWN && (rank == RANK_1 || rank == RANK_8)) {
+                return false;
+            }
+        }
+        Color mover = opposite(placement.sideToMove);
+        return !attacked(placement, placement.king(mover), placement.sideToMove);
+    }
+
+    // Kings only, or a single minor piece besides them: nobody can win
+    bool isInsufficient(const Placement& placement) {
+        int minors = 0;
+        for (int i = 0; i < placement.count; ++i) {
+            PieceType piece = placement.types[i];
+            if (piece == PAWN || piece == ROOK || piece == QUEEN) {
+                return false;
+            }
+            if (piece == KNIGHT || piece == BISHOP) {
+                minors++;
+            }
+        }
+        return minors <= 1;
+    }
+
+    // Call visit(next, converts) for every legal move of the side to move, where converts
+    // tells if the move is a capture or promotion leading into another ending
+    template <typename Visitor>
+    void forEachMove(const Placement& placement, Visitor visit) {
+        const Color us = placement.sideToMove;
+        const Bitboard occupied = placement.occupied();
+        const Bitboard ours = placement.pieces(us);
+        const Bitboard theirs = placement.pieces(opposite(us));
+
+        for (int i = 0; i < placement.count; ++i) {
+            if (placement.colors[i] != us) {
+                continue;
+            }
+
+            Square from = placement.squares[i];
+            PieceType piece = placement.types[i];
+            Bitboard targets;
+            if (piece == PAWN) {
+                int forward = us == WHITE ? 8 : -8;
+                Square push = static_cast<Square>(from + forward);
+                targets = BitboardConstants::PAWN_ATTACKS[us][from] & theirs;
+                if (!(occupied & (1ULL << push))) {
+                    targets |= 1ULL << push;
+                    int startRank = us == WHITE ? RANK_2 : RANK_7;
+                    Square doublePush = static_cast<Square>(push + forward);
+                    if (BitboardUtils::squareRank(from) == startRank && !(occupied & (1ULL << doublePush))) {
+                        targets |= 1ULL << doublePush;
+                    }
+                }
+            } else {
+                targets = MoveGenerator::getPieceAttacks(piece, from, us, occupied) & ~ours;
+            }
+
+            while (targets) {
+                Square to = BitboardUtils::lsb(targets);
+                targets &= targets - 1;
+
+                Placement next = placement;
+                int moving = i;
+                int captured = placement.pieceOn(to);
+                if (captured >= 0) {
+                    next.remove(captured);
+                    if (captured < moving) {
+                        moving--;
+                    }
+                }
+                next.squares[moving] = to;
+                next.sideToMove = opposite(us);
+
+                // Our king may not be left in check
+                if (attacked(next, next.king(us), opposite(us))) {
+                    continue;
+                }
+
+                int rank = BitboardUtils::squareRank(to);
+                if (piece == PAWN && (rank == RANK_1 || rank == RANK_8)) {
+                    for (PieceType promotion : {QUEEN, ROOK, BISHOP, KNIGHT}) {
+                        next.types[moving] = promotion;
+                        visit(next, true);
+                    }
+                } else {
+                    visit(next, captured >= 0);
+                }
+            }
+        }
+    }
+
+    // Call visit(previous) for every position in the same ending that leads here by a
+    // move of the side that just moved (no captures or promotions)
+    template <typename Visitor>
+    void forEachUnmove(const Placement& placement, Visitor visit) {
+        const Color mover = opposite(placement.sideToMove);
+        const Bitboard occupied = placement.occupied();
+
+        for (int i = 0; i < placement.count; ++i) {
+            if (placement.colors[i] != mover) {
+                continue;
+            }
+
+            Square to = placement.squares[i];
+            Bitboard origins;
+            if (placement.types[i] == PAWN) {
+                // A pawn came from the square behind it, or two behind from its starting rank
+                int backward = mover == WHITE ? -8 : 8;
+                int relativeRank = mover == WHITE ? BitboardUtils::squareRank(to) : 7 - BitboardUtils::squareRank(to);
+                Square single = static_cast<Square>(to + backward);
+                origins = 0;
+                if (relativeRank >= RANK_3 && !(occupied & (1ULL << single))) {
+                    origins |= 1ULL << single;
+                    Square doubleOrigin = static_cast<Square>(single + backward);
+                    if (relativeRank == RANK_4 && !(occupied & (1ULL << doubleOrigin))) {
+                        origins |= 1ULL << doubleOrigin;
+                    }
+                }
+            } else {
+                origins = MoveGenerator::getPieceAttacks(placement.types[i], to, mover, occupied) & ~occupied;
+            }
+
+            while (origins) {
+                Square from = BitboardUtils::lsb(origins);
+                origins &= origins - 1;
+
+                Placement previous = placement;
+                previous.squares[i] = from;
+                previous.sideToMove = mover;
+                visit(previous);
+            }
+        }
+    }
+
+    // A table available for probing, either mapped from a file or held in memory
+    struct Table {
+        Ending ending;
+        int strongKey = 0;
+        int weakKey = 0;
+        const uint8_t* data = nullptr;
+        size_t positions = 0;
+        std::vector<uint8_t> owned;
+        void* mapping = nullptr;
+        size_t mappingBytes = 0;
+
+        ~Table() {
+#ifndef _WIN32
+            if (mapping) {
+                munmap(mapping, mappingBytes);
+            }
+#endif
+        }
+
+        uint8_t value(size_t index) const {
+            return (data[index >> 2] >> ((index & 3) * 2)) & 3;
+        }
+    };
+
+    std::vector<std::unique_ptr<Table>> tables;
+    int largestTable = 0;
+
+    void registerTable(std::unique_ptr<Table> table) {
+        table->strongKey = materialKey(table->ending.strong);
+        table->weakKey = materialKey(table->ending.weak);
+
+        // A new table for the same ending replaces the old one
+        tables.erase(std::remove_if(tables.begin(), tables.end(),
+                                    [&](const std::unique_ptr<Table>& t) { return t->ending.name == table->ending.name; }),
+                     tables.end());
+        tables.push_back(std::move(table));
+
+        largestTable = 0;
+        for (const auto& t : tables) {
+            largestTable = std::max(largestTable, 2 + static_cast<int>(t->ending.strong.size() + t->ending.weak.size()));
+        }
+    }
+
+    // Look up a set of pieces in whichever table covers it, mirroring colors if the
+    // stronger side is Black. Returns the stored value, or INVALID if there's no table.
+    uint8_t lookup(const Placement& placement) {
+        int whiteKey = materialKey(placement, WHITE);
+        int blackKey = materialKey(placement, BLACK);
+
+        for (const auto& table : tables) {
+            bool flip;
+            if (table->strongKey == whiteKey && table->weakKey == blackKey) {
+                flip = false;
+            } else if (table->strongKey == blackKey && table->weakKey == whiteKey) {
+                flip = true;
+            } else {
+                continue;
+            }
+
+            // Arrange the pieces in the table's order, with the stronger side as White
+            Placement canonical = layout(table->ending);
+            bool used[MAX_PIECES] = {};
+            for (int slot = 0; slot < canonical.count; ++slot) {
+                Color wanted = flip ? opposite(canonical.colors[slot]) : canonical.colors[slot];
+                for (int i = 0; i < placement.count; ++i) {
+                    if (!used[i] && placement.types[i] == canonical.types[slot] && placement.colors[i] == wanted) {
+                        used[i] = true;
+                        canonical.squares[slot] = static_cast<Square>(flip ? placement.squares[i] ^ 56 : placement.squares[i]);
+                        break;
+                    }
+                }
+            }
+            canonical.sideToMove = flip ? opposite(placement.sideToMove) : placement.sideToMove;
+            return table->value(indexOf(canonical));
+        }
+        return INVALID;
+    }
+
+    WDL toWDL(uint8_t value) {
+        return value == WON ? Bitbases::WIN : value == LOST ? Bitbases::LOSS : Bitbases::DRAW;
+    }
+}
+
+namespace Bitbases {
+    const std::vector<Ending>& endings() {
+        static const std::vector<Ending> ENDINGS = {
+            {"KQK", {QUEEN}, {}},
+            {"KRK", {ROOK}, {}},
+            {"KPK", {PAWN}, {}},
+            {"KQKR", {QUEEN}, {ROOK}},
+            {"KRKB", {ROOK}, {BISHOP}},
+            {"KRKN", {ROOK}, {KNIGHT}},
+            {"KBNK", {BISHOP, KNIGHT}, {}},
+        };
+        return ENDINGS;
+    }
+
+    size_t tableSize(const Ending& ending) {
+        size_t size = 2;
+        for (size_t i = 0; i < 2 + ending.strong.size() + ending.weak.size(); ++i) {
+            size *= 64;
+        }
+        return size;
+    }
+
+    std::string tableFile(const std::string& directory, const Ending& ending) {
+        return directory + "/" + ending.name + ".bb";
+    }
+
+    bool generate(const Ending& ending, std::vector<uint8_t>& table, int threads) {
+        const Placement pieces = layout(ending);
+        const size_t size = tableSize(ending);
+        std::vector<uint8_t> values(size, INVALID);
+        std::vector<uint8_t> counters(size, 0);
+        std::atomic<bool> missingTable(false);
+
+        // Pass 1: decide mates, stalemates and positions settled by a conversion, and count
+        // the moves staying in the ending for the rest
+        auto classify = [&](size_t begin, size_t end) {
+            Placement placement = pieces;
+            for (size_t index = begin; index < end; ++index) {
+                decode(index, placement);
+                if (!isValid(placement)) {
+                    continue;
+                }
+
+                int moves = 0;
+                int inside = 0;
+                bool winningExit = false;
+                bool drawingExit = false;
+                forEachMove(placement, [&](const Placement& next, bool converts) {
+                    moves++;
+                    if (!converts) {
+                        inside++;
+                        return;
+                    }
+                    uint8_t value = isInsufficient(next) ? DRAWN : lookup(next);
+                    if (value == INVALID) {
+                        missingTable = true;
+                    } else if (value == LOST) {
+                        winningExit = true;
+                    } else if (value == DRAWN) {
+                        drawingExit = true;
+                    }
+                });
+
+                if (winningExit) {
+                    values[index] = WON;
+                } else if (moves == 0) {
+                    values[index] = inCheck(placement) ? LOST : DRAWN;
+                } else if (inside == 0) {
+                    values[index] = drawingExit ? DRAWN : LOST;
+                } else {
+                    values[index] = UNKNOWN;
+                    counters[index] = static_cast<uint8_t>(inside | (drawingExit ? DRAW_EXIT : 0));
+                }
+            }
+        };
+
+        threads = std::max(threads, 1);
+        std::vector<std::thread> workers;
+        size_t chunk = (size + threads - 1) / threads;
+        for (int t = 0; t < threads; ++t) {
+            size_t begin = std::min(size, t * chunk);
+            size_t end = std::min(size, begin + chunk);
+            workers.emplace_back(classify, begin, end);
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        if (missingTable) {
+            return false;
+        }
+
+        // Pass 2: walk back from decided positions. A loss makes every position leading to it
+        // a win; a position whose moves all lead to wins for the opponent is lost, unless it
+        // can convert into a draw.
+        std::vector<uint32_t> queue;
+        for (size_t index = 0; index < size; ++index) {
+            if (values[index] == WON || values[index] == LOST) {
+                queue.push_back(static_cast<uint32_t>(index));
+            }
+        }
+
+        Placement placement = pieces;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            size_t index = queue[head];
+            bool lost = values[index] == LOST;
+            decode(index, placement);
+            forEachUnmove(placement, [&](const Placement& previous) {
+                size_t prev = indexOf(previous);
+                if (values[prev] != UNKNOWN) {
+                    return;
+                }
+                if (lost) {
+                    values[prev] = WON;
+                    queue.push_back(static_cast<uint32_t>(prev));
+                } else if (((--counters[prev]) & ~DRAW_EXIT) == 0) {
+                    values[prev] = (counters[prev] & DRAW_EXIT) ? DRAWN : LOST;
+                    if (values[prev] == LOST) {
+                        queue.push_back(static_cast<uint32_t>(prev));
+                    }
+                }
+            });
+        }
+
+        // Whatever is left can't be forced either way
+        table.assign((size + 3) / 4, 0);
+        for (size_t index = 0; index < size; ++index) {
+            uint8_t value = values[index] == UNKNOWN ? DRAWN : values[index];
+            table[index >> 2] |= value << ((index & 3) * 2);
+        }
+        return true;
+    }
+
+    bool save(const std::string& filename, const std::vector<uint8_t>& table) {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        FileHeader header = {FILE_MAGIC, FILE_VERSION, table.size() * 4};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(table.data()), table.size());
+        return file.good();
+    }
+
+    void add(const Ending& ending, std::vector<uint8_t> table) {
+        auto entry = std::make_unique<Table>();
+        entry->ending = ending;
+        entry->owned = std::move(table);
+        entry->data = entry->owned.data();
+        entry->positions = tableSize(ending);
+        registerTable(std::move(entry));
+    }
+
+    int load(const std::string& directory) {
+        for (const Ending& ending : endings()) {
+            std::string filename = tableFile(directory, ending);
+            size_t expectedBytes = sizeof(FileHeader) + (tableSize(ending) + 3) / 4;
+
+            auto entry = std::make_unique<Table>();
+            entry->ending = ending;
+            entry->positions = tableSize(ending);
+
+#ifdef _WIN32
+            std::ifstream file(filename, std::ios::binary);
+            if (!file.is_open()) {
+                continue;
+            }
+            std::vector<uint8_t> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            if (contents.size() != expectedBytes) {
+                continue;
+            }
+            const FileHeader* header = reinterpret_cast<const FileHeader*>(contents.data());
+            if (header->magic != FILE_MAGIC || header->version != FILE_VERSION) {
+                continue;
+            }
+            entry->owned.assign(contents.begin() + sizeof(FileHeader), contents.end());
+            entry->data = entry->owned.data();
+#else
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd < 0) {
+                continue;
+            }
+            struct stat st;
+            if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != expectedBytes) {
+                ::close(fd);
+                continue;
+            }
+            void* mapping = mmap(nullptr, expectedBytes, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (mapping == MAP_FAILED) {
+                continue;
+            }
+            entry->mapping = mapping;
+            entry->mappingBytes = expectedBytes;
+
+            const FileHeader* header = static_cast<const FileHeader*>(mapping);
+            if (header->magic != FILE_MAGIC || header->version != FILE_VERSION) {
+                continue;
+            }
+            entry->data = static_cast<const uint8_t*>(mapping) + sizeof(FileHeader);
+#endif
+            registerTable(std::move(entry));
+        }
+        return static_cast<int>(tables.size());
+    }
+
+    bool available(const Ending& ending) {
+        return std::any_of(tables.begin(), tables.end(),
+                           [&](const std::unique_ptr<Table>& t) { return t->ending.name == ending.name; });
+    }
+
+    void clear() {
+        tables.clear();
+        largestTable = 0;
+    }
+
+    int maxPieces() {
+        return largestTable;
+    }
+
+    bool probe(const Board& board, WDL& result) {
+        if (BitboardUtils::popCount(board._occupiedSquares) > largestTable) {
+            return false;
+        }
+
+        // Kings first, then the other pieces
+        Placement placement;
+        for (int color = WHITE; color <= BLACK; ++color) {
+            placement.squares[color] = BitboardUtils::lsb(board._pieces[color][KING]);
+            placement.types[color] = KING;
+            placement.colors[color] = Color(color);
+        }
+        placement.count = 2;
+        for (int color = WHITE; color <= BLACK; ++color) {
+            for (int piece = PAWN; piece < KING; ++piece) {
+                Bitboard pieces = board._pieces[color][piece];
+                while (pieces) {
+                    placement.squares[placement.count] = BitboardUtils::lsb(pieces);
+                    placement.types[placement.count] = PieceType(piece);
+                    placement.colors[placement.count++] = Color(color);
+                    pieces &= pieces - 1;
+                }
+            }
+        }
+        placement.sideToMove = board.sideToMove();
+
+        uint8_t value = lookup(placement);
+        if (value == INVALID) {
+            return false;
+        }
+        result = toWDL(value);
+        return true;
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef BITBASE_H
+#define BITBASE_H
+
+#include "board.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Directory the bitbase files are generated into and loaded from
+const char* const DEFAULT_BITBASE_DIRECTORY = "bitbases";
+
+// Win/draw/loss tables for small endings, generated locally by retrograde analysis
+// (see generate_bitbases.cpp) and memory-mapped for probing
+namespace Bitbases {
+    // Game-theoretic result for the side to move, ignoring the fifty-move rule
+    enum WDL {
+        LOSS = -1,
+        DRAW = 0,
+        WIN = 1
+    };
+
+    // An ending: the pieces besides the king of the stronger and the weaker side
+    struct Ending {
+        std::string name;
+        std::vector<PieceType> strong;
+        std::vector<PieceType> weak;
+    };
+
+    // Endings with tables, in generation order (captures and promotions only lead to earlier ones)
+    const std::vector<Ending>& endings();
+
+    // Number of positions indexed by an ending's table (both sides to move)
+    size_t tableSize(const Ending& ending);
+
+    // Name of an ending's table file in a directory
+    std::string tableFile(const std::string& directory, const Ending& ending);
+
+    // Solve an ending by retrograde analysis into a packed table (2 bits per position). The tables
+    // of the endings it converts into must be available. False if one of them is missing.
+    bool generate(const Ending& ending, std::vector<uint8_t>& table, int threads = 1);
+
+    // Write a packed table to a file
+    bool save(const std::string& filename, const std::vector<uint8_t>& table);
+
+    // Make an in-memory table available for probing
+    void add(const Ending& ending, std::vector<uint8_t> table);
+
+    // Memory-map the table of every ending found in a directory, returns the number available
+    int load(const std::string& directory);
+
+    // Check if an ending's table is available
+    bool available(const Ending& ending);
+
+    // Forget all tables (no probe may be running)
+    void clear();
+
+    // Largest number of pieces, kings included, of an available table (0 without tables)
+    int maxPieces();
+
+    // Look up a position, false if no table covers it (thread-safe)
+    bool probe(const Board& board, WDL& result);
+}
+
+#endif // BITBASE_H
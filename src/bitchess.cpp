@@ -0,0 +1,240 @@
+#include "bitchess.h"
+#include "bitbase.h"
+#include "board.h"
+#include "chess_rl.h"
+#include "engine.h"
+#include "feature_extractor.h"
+#include "search.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Transposition table size of a search created without one
+constexpr size_t DEFAULT_LIBRARY_HASH_MB = 16;
+
+struct bitchess_board {
+    Board board;
+};
+
+struct bitchess_network {
+    std::shared_ptr<NeuralNetwork> network;
+};
+
+struct bitchess_search {
+    Search search;
+};
+
+namespace {
+    // The attack tables are set up once, by whichever call needs them first
+    void initialize() {
+        static std::once_flag initialized;
+        std::call_once(initialized, BitboardUtils::initBitboards);
+    }
+
+    // Value of every row of a batch that couldn't be evaluated
+    void fillNan(float* values, size_t count) {
+        std::fill(values, values + count, std::numeric_limits<float>::quiet_NaN());
+    }
+}
+
+// Exceptions (only std::bad_alloc in practice) must not cross the C interface,
+// each entry point that can allocate turns them into its failure result
+
+const char* bitchess_version(void) {
+    return BITCHESS_VERSION;
+}
+
+int bitchess_load_bitbases(const char* directory) {
+    try {
+        initialize();
+        return Bitbases::load(directory ? directory : DEFAULT_BITBASE_DIRECTORY);
+    } catch (...) {
+        return 0;
+    }
+}
+
+bitchess_board* bitchess_board_new(const char* fen) {
+    try {
+        initialize();
+        auto board = std::make_unique<bitchess_board>();
+        if (!fen) {
+            board->board.reset();
+        } else if (!board->board.setFromFen(fen)) {
+            return nullptr;
+        }
+        return board.release();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+bitchess_board* bitchess_board_copy(const bitchess_board* board) {
+    try {
+        return new bitchess_board(*board);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void bitchess_board_free(bitchess_board* board) {
+    delete board;
+}
+
+size_t bitchess_board_fen(const bitchess_board* board, char* buffer, size_t size) {
+    try {
+        std::string fen = board->board.getFen();
+        if (fen.size() >= size) {
+            return 0;
+        }
+        std::memcpy(buffer, fen.c_str(), fen.size() + 1);
+        return fen.size();
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t bitchess_generate_moves(const bitchess_board* board, uint16_t* moves, size_t capacity) {
+    try {
+        std::vector<Move> legal = board->board.generateLegalMoves();
+        size_t count = std::min(legal.size(), capacity);
+        for (size_t i = 0; i < count; ++i) {
+            moves[i] = legal[i].pack();
+        }
+        return legal.size();
+    } catch (...) {
+        return 0;
+    }
+}
+
+int bitchess_make_move(bitchess_board* board, uint16_t move) {
+    try {
+        // makeMove doesn't check that the piece can reach the square, so compare with the legal moves
+        Move played = Move::unpack(move);
+        std::vector<Move> legal = board->board.generateLegalMoves();
+        if (!played.isValid() || std::find(legal.begin(), legal.end(), played) == legal.end()) {
+            return 0;
+        }
+        return board->board.makeMove(played) ? 1 : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+uint16_t bitchess_move_from_uci(const char* text) {
+    try {
+        return text ? Move::fromUci(text).pack() : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t bitchess_move_to_uci(uint16_t move, char* buffer) {
+    size_t length = Move::unpack(move).toUci(buffer);
+    buffer[length] = '\0';
+    return length;
+}
+
+size_t bitchess_feature_size(void) {
+    return BoardFeatureExtractor::getFeatureSize();
+}
+
+void bitchess_extract_features(const bitchess_board* const* boards, size_t count, float* features) {
+    const size_t size = BoardFeatureExtractor::getFeatureSize();
+    for (size_t i = 0; i < count; ++i) {
+        BoardFeatureExtractor::extractFeatures(boards[i]->board, features + i * size);
+    }
+}
+
+bitchess_network* bitchess_network_load(const char* path) {
+    try {
+        std::shared_ptr<NeuralNetwork> network = loadValueNetwork(path ? path : DEFAULT_MODEL_FILE);
+        if (!network) {
+            return nullptr;
+        }
+        return new bitchess_network{network};
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void bitchess_network_free(bitchess_network* network) {
+    delete network;
+}
+
+void bitchess_network_evaluate(const bitchess_network* network, const bitchess_board* const* boards,
+                               size_t count, float* values) {
+    try {
+        std::vector<float> features(count * BoardFeatureExtractor::getFeatureSize());
+        bitchess_extract_features(boards, count, features.data());
+        bitchess_network_evaluate_features(network, features.data(), count, values);
+    } catch (...) {
+        fillNan(values, count);
+    }
+}
+
+void bitchess_network_evaluate_features(const bitchess_network* network, const float* features,
+                                        size_t count, float* values) {
+    try {
+        network->network->evaluateBatch(features, count, values);
+    } catch (...) {
+        fillNan(values, count);
+    }
+}
+
+bitchess_search* bitchess_search_new(size_t hash_mb) {
+    try {
+        initialize();
+        auto search = std::make_unique<bitchess_search>();
+        search->search.setHashSize(hash_mb > 0 ? hash_mb : DEFAULT_LIBRARY_HASH_MB);
+        return search.release();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void bitchess_search_free(bitchess_search* search) {
+    delete search;
+}
+
+void bitchess_search_clear(bitchess_search* search) {
+    search->search.clear();
+}
+
+void bitchess_search_run(bitchess_search* search, const bitchess_board* const* boards, size_t count,
+                         const bitchess_limits* limits, bitchess_result* results) {
+    SearchLimits searchLimits;
+    searchLimits.depth = DEFAULT_SEARCH_DEPTH;
+    if (limits && (limits->depth > 0 || limits->nodes > 0 || limits->movetime_ms > 0)) {
+        searchLimits.depth = limits->depth > 0 ? std::min(limits->depth, MAX_PLY - 1) : MAX_PLY - 1;
+        searchLimits.nodes = limits->nodes;
+        searchLimits.moveTime = limits->movetime_ms;
+    }
+
+    search->search.clearRequests();
+    size_t i = 0;
+    try {
+        for (; i < count; ++i) {
+            // A stop ends the whole batch, the positions not searched get empty results
+            if (search->search.stopRequested()) {
+                results[i] = bitchess_result{};
+                continue;
+            }
+
+            SearchResult result = search->search.run(boards[i]->board, searchLimits);
+            results[i].best_move = result.bestMove.pack();
+            results[i].ponder_move = result.ponderMove.pack();
+            results[i].score = result.score;
+            results[i].depth = result.depth;
+            results[i].nodes = result.nodes;
+        }
+    } catch (...) {
+        std::fill(results + i, results + count, bitchess_result{});
+    }
+}
+
+void bitchess_search_stop(bitchess_search* search) {
+    search->search.stop();
+}
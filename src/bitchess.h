@@ -0,0 +1,133 @@
+#ifndef BITCHESS_H
+#define BITCHESS_H
+
+/*
+ * C interface of the engine, built as the libbitchess shared library.
+ *
+ * Moves are passed in their packed 16-bit form: source square in bits 0-5,
+ * destination square in bits 6-11 (A1 = 0, B1 = 1, ..., H8 = 63) and the
+ * promotion piece in bits 12-14 (1 knight, 2 bishop, 3 rook, 4 queen, 6 none).
+ * 0 is not a move.
+ *
+ * Objects may be used from many threads, but each board and search by one
+ * thread at a time. Networks are read-only and can be shared freely.
+ *
+ * No function lets a C++ exception escape: when memory runs out, those
+ * returning a pointer return NULL and those returning a count return 0.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(BITCHESS_BUILD_LIBRARY)
+#  define BITCHESS_API __declspec(dllexport)
+#elif defined(__GNUC__)
+#  define BITCHESS_API __attribute__((visibility("default")))
+#else
+#  define BITCHESS_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Most legal moves of any chess position */
+#define BITCHESS_MAX_MOVES 256
+
+/* Size of a buffer holding a move as UCI text with its terminating zero */
+#define BITCHESS_UCI_MOVE_SIZE 6
+
+typedef struct bitchess_board bitchess_board;
+typedef struct bitchess_network bitchess_network;
+typedef struct bitchess_search bitchess_search;
+
+/* Limits of a search (zero means no limit; without any, depth 6 is searched) */
+typedef struct bitchess_limits {
+    int depth;
+    uint64_t nodes;
+    int64_t movetime_ms;
+} bitchess_limits;
+
+/* Result of a search, the score in centipawns from the side to move's point of view
+   (a mate in n plies scores 32000 - n, being mated -(32000 - n)) */
+typedef struct bitchess_result {
+    uint16_t best_move;
+    uint16_t ponder_move;
+    int score;
+    int depth;
+    uint64_t nodes;
+} bitchess_result;
+
+/* Version of the library as "major.minor.patch" */
+BITCHESS_API const char* bitchess_version(void);
+
+/* Load the endgame bitbases of a directory for the searches; returns the number of files.
+   The tables are shared by every search of the process and replaced without locking:
+   call it before starting any search, never while one may be running. */
+BITCHESS_API int bitchess_load_bitbases(const char* directory);
+
+/* Board of a FEN position, or of the starting position for NULL; NULL if the FEN is invalid */
+BITCHESS_API bitchess_board* bitchess_board_new(const char* fen);
+
+/* Independent copy of a board */
+BITCHESS_API bitchess_board* bitchess_board_copy(const bitchess_board* board);
+
+BITCHESS_API void bitchess_board_free(bitchess_board* board);
+
+/* Write the FEN of a board with its terminating zero; returns its length, or 0 if it doesn't fit */
+BITCHESS_API size_t bitchess_board_fen(const bitchess_board* board, char* buffer, size_t size);
+
+/* Write up to capacity legal moves; returns the number of legal moves (at most BITCHESS_MAX_MOVES) */
+BITCHESS_API size_t bitchess_generate_moves(const bitchess_board* board, uint16_t* moves, size_t capacity);
+
+/* Play a move; returns 0 and leaves the board unchanged if it is illegal */
+BITCHESS_API int bitchess_make_move(bitchess_board* board, uint16_t move);
+
+/* Packed form of a move in UCI text (e.g. "e7e8q"), 0 if the text is not a move */
+BITCHESS_API uint16_t bitchess_move_from_uci(const char* text);
+
+/* Write a move as UCI text into a buffer of BITCHESS_UCI_MOVE_SIZE characters; returns its length */
+BITCHESS_API size_t bitchess_move_to_uci(uint16_t move, char* buffer);
+
+/* Number of network input features of a position */
+BITCHESS_API size_t bitchess_feature_size(void);
+
+/* Write the features of count boards, one row of bitchess_feature_size() values each */
+BITCHESS_API void bitchess_extract_features(const bitchess_board* const* boards, size_t count, float* features);
+
+/* Value network of a file; NULL if the file doesn't hold a network of the engine's topology */
+BITCHESS_API bitchess_network* bitchess_network_load(const char* path);
+
+BITCHESS_API void bitchess_network_free(bitchess_network* network);
+
+/* Evaluate count boards with one batched forward pass, values from White's point of view
+   (NaN for every board if the batch can't be allocated) */
+BITCHESS_API void bitchess_network_evaluate(const bitchess_network* network, const bitchess_board* const* boards,
+                                            size_t count, float* values);
+
+/* Evaluate count rows of features written by bitchess_extract_features (NaN for every
+   row if the batch can't be allocated) */
+BITCHESS_API void bitchess_network_evaluate_features(const bitchess_network* network, const float* features,
+                                                     size_t count, float* values);
+
+/* Alpha-beta search with its own transposition table of hash_mb megabytes (16 for 0) */
+BITCHESS_API bitchess_search* bitchess_search_new(size_t hash_mb);
+
+BITCHESS_API void bitchess_search_free(bitchess_search* search);
+
+/* Forget the transposition table and move ordering statistics */
+BITCHESS_API void bitchess_search_clear(bitchess_search* search);
+
+/* Search each of count boards within the limits (NULL for the default depth); positions
+   not searched, after a stop or when memory runs out, get empty (all zero) results */
+BITCHESS_API void bitchess_search_run(bitchess_search* search, const bitchess_board* const* boards, size_t count,
+                                      const bitchess_limits* limits, bitchess_result* results);
+
+/* Ask a running search to stop as soon as possible (callable from any thread) */
+BITCHESS_API void bitchess_search_stop(bitchess_search* search);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BITCHESS_H */
@@ -1,41 +1,43 @@
 #include "board.h"
 #include "movegen.h"
 #include <sstream>
+#include <algorithm>
 #include <cctype>
 #include <unordered_map>
 
 // Convert move to UCI string
 std::string Move::toUci() const {
+    char uci[MAX_UCI_MOVE_LENGTH];
+    return std::string(uci, toUci(uci));
+}
+
+// Write move as UCI text into a fixed buffer
+size_t Move::toUci(char* buffer) const {
     if (!isValid()) {
-        return "0000";
+        buffer[0] = buffer[1] = buffer[2] = buffer[3] = '0';
+        return 4;
     }
     
-    std::string uci;
-    
     // Add source square
-    uci += 'a' + BitboardUtils::squareFile(from);
-    uci += '1' + BitboardUtils::squareRank(from);
+    buffer[0] = static_cast<char>('a' + BitboardUtils::squareFile(from));
+    buffer[1] = static_cast<char>('1' + BitboardUtils::squareRank(from));
     
     // Add destination square
-    uci += 'a' + BitboardUtils::squareFile(to);
-    uci += '1' + BitboardUtils::squareRank(to);
+    buffer[2] = static_cast<char>('a' + BitboardUtils::squareFile(to));
+    buffer[3] = static_cast<char>('1' + BitboardUtils::squareRank(to));
     
     // Add promotion piece if applicable
-    if (promotion != NO_PIECE_TYPE) {
-        switch (promotion) {
-            case QUEEN:  uci += 'q'; break;
-            case ROOK:   uci += 'r'; break;
-            case BISHOP: uci += 'b'; break;
-            case KNIGHT: uci += 'n'; break;
-            default: break;
-        }
+    switch (promotion) {
+        case QUEEN:  buffer[4] = 'q'; return 5;
+        case ROOK:   buffer[4] = 'r'; return 5;
+        case BISHOP: buffer[4] = 'b'; return 5;
+        case KNIGHT: buffer[4] = 'n'; return 5;
+        default: return 4;
     }
-    
-    return uci;
 }
 
 // Create move from UCI string
-Move Move::fromUci(const std::string& uci) {
+Move Move::fromUci(std::string_view uci) {
     if (uci.length() < 4 || uci.length() > 5) {
         return Move(); // Invalid UCI string
     }
@@ -122,6 +124,11 @@ void Board::reset() {
     _enPassantSquare = NO_SQUARE;
     _halfmoveClock = 0;
     _fullmoveNumber = 1;
+    
+    // Compute the hash key of the starting position
+    _hash = Zobrist::computeKey(*this);
+    _pawnHash = Zobrist::computePawnKey(*this);
+    Eval::computePsqt(*this, _psqt, _phase);
 }
 
 // Update all combined bitboards
@@ -190,6 +197,11 @@ bool Board::makeMove(const Move& move) {
     // Check if move is a capture
     bool isCapture = (capturedColor != NO_COLOR);
     
+    // Remember the previous state for the incremental hash update
+    const auto piecesBefore = _pieces;
+    const int castlingBefore = _castlingRights;
+    const Square enPassantBefore = _enPassantSquare;
+    
     // Handle special move: Castling
     if (movingPiece == KING) {
         // Kingside castling
@@ -276,6 +288,9 @@ bool Board::makeMove(const Move& move) {
             }
             _pieces[movingColor][movingPiece] |= (1ULL << move.to);
         }
+        
+        // Reset en passant square
+        _enPassantSquare = NO_SQUARE;
     }
     // Handle en passant capture
     else if (movingPiece == PAWN && move.to == _enPassantSquare) {
@@ -304,6 +319,9 @@ bool Board::makeMove(const Move& move) {
         
         // Add promoted piece
         _pieces[movingColor][move.promotion] |= (1ULL << move.to);
+        
+        // Reset en passant square
+        _enPassantSquare = NO_SQUARE;
     }
     // Handle pawn double push
     else if (movingPiece == PAWN && 
@@ -332,17 +350,6 @@ bool Board::makeMove(const Move& move) {
             }
         }
         
-        // Check for rook captures
-        if (isCapture && capturedPiece == ROOK) {
-            if (capturedColor == WHITE) {
-                if (move.to == A1) _castlingRights &= ~WHITE_OOO;
-                if (move.to == H1) _castlingRights &= ~WHITE_OO;
-            } else {
-                if (move.to == A8) _castlingRights &= ~BLACK_OOO;
-                if (move.to == H8) _castlingRights &= ~BLACK_OO;
-            }
-        }
-        
         // Move piece
         _pieces[movingColor][movingPiece] &= ~(1ULL << move.from);
         if (isCapture) {
@@ -354,6 +361,17 @@ bool Board::makeMove(const Move& move) {
         _enPassantSquare = NO_SQUARE;
     }
     
+    // Check for rook captures (by any piece, including promotions and king moves)
+    if (isCapture && capturedPiece == ROOK) {
+        if (capturedColor == WHITE) {
+            if (move.to == A1) _castlingRights &= ~WHITE_OOO;
+            if (move.to == H1) _castlingRights &= ~WHITE_OO;
+        } else {
+            if (move.to == A8) _castlingRights &= ~BLACK_OOO;
+            if (move.to == H8) _castlingRights &= ~BLACK_OO;
+        }
+    }
+    
     // Update bitboards
     updateCombinedBitboards();
     
@@ -378,9 +396,56 @@ bool Board::makeMove(const Move& move) {
         _fullmoveNumber++;
     }
     
+    // Update hash keys, piece-square score and phase for every square whose contents changed
+    for (int color = WHITE; color <= BLACK; ++color) {
+        for (int piece = PAWN; piece <= KING; ++piece) {
+            Bitboard changed = piecesBefore[color][piece] ^ _pieces[color][piece];
+            while (changed) {
+                Square sq = BitboardUtils::lsb(changed);
+                _hash ^= Zobrist::PIECE_KEYS[color][piece][sq];
+                if (piece == PAWN) {
+                    _pawnHash ^= Zobrist::PIECE_KEYS[color][PAWN][sq];
+                }
+                if (_pieces[color][piece] & (1ULL << sq)) {
+                    _psqt += Eval::PSQT[color][piece][sq];
+                    _phase += Eval::PHASE_WEIGHTS[piece];
+                } else {
+                    _psqt -= Eval::PSQT[color][piece][sq];
+                    _phase -= Eval::PHASE_WEIGHTS[piece];
+                }
+                changed &= changed - 1;
+            }
+        }
+    }
+    
+    // Update hash key for castling rights, en passant square and side to move
+    _hash ^= Zobrist::CASTLING_KEYS[castlingBefore] ^ Zobrist::CASTLING_KEYS[_castlingRights];
+    if (enPassantBefore != NO_SQUARE) {
+        _hash ^= Zobrist::EN_PASSANT_KEYS[BitboardUtils::squareFile(enPassantBefore)];
+    }
+    if (_enPassantSquare != NO_SQUARE) {
+        _hash ^= Zobrist::EN_PASSANT_KEYS[BitboardUtils::squareFile(_enPassantSquare)];
+    }
+    _hash ^= Zobrist::SIDE_KEY;
+    
     return true;
 }
 
+// Pass the turn to the opponent without moving
+void Board::makeNullMove() {
+    // Clear en passant square
+    if (_enPassantSquare != NO_SQUARE) {
+        _hash ^= Zobrist::EN_PASSANT_KEYS[BitboardUtils::squareFile(_enPassantSquare)];
+        _enPassantSquare = NO_SQUARE;
+    }
+    
+    // Switch side to move
+    _sideToMove = (_sideToMove == WHITE) ? BLACK : WHITE;
+    _hash ^= Zobrist::SIDE_KEY;
+    
+    _halfmoveClock++;
+}
+
 // Generate all legal moves
 std::vector<Move> Board::generateLegalMoves() const {
     return MoveGenerator::generateLegalMoves(*this);
@@ -413,6 +478,12 @@ bool Board::isInCheck(Color color) const {
     return kingSquare != NO_SQUARE && isSquareAttacked(kingSquare, Color(1 - color));
 }
 
+// Check if a color has any pieces besides pawns and king
+bool Board::hasNonPawnMaterial(Color color) const {
+    return (_pieces[color][KNIGHT] | _pieces[color][BISHOP] |
+            _pieces[color][ROOK] | _pieces[color][QUEEN]) != 0;
+}
+
 // Find the king square for a given color
 Square Board::findKing(Color color) const {
     return BitboardUtils::lsb(_pieces[color][KING]);
@@ -532,6 +603,102 @@ bool Board::setFromFen(const std::string& fen) {
     // Update combined bitboards
     updateCombinedBitboards();
     
+    // Compute the hash key of the new position
+    _hash = Zobrist::computeKey(*this);
+    _pawnHash = Zobrist::computePawnKey(*this);
+    Eval::computePsqt(*this, _psqt, _phase);
+    
+    return true;
+}
+
+// Write the position in its packed binary form
+void Board::pack(uint8_t* out) const {
+    std::fill(out, out + PACKED_BOARD_SIZE, 0);
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<uint8_t>(_occupiedSquares >> (8 * i));
+    }
+    
+    // Piece codes of the occupied squares, two per byte
+    int index = 0;
+    for (Bitboard occupied = _occupiedSquares; occupied; occupied &= occupied - 1) {
+        Color color;
+        PieceType piece = pieceAt(BitboardUtils::lsb(occupied), color);
+        out[8 + index / 2] |= static_cast<uint8_t>((color * 6 + piece) << (4 * (index % 2)));
+        index++;
+    }
+    
+    out[24] = static_cast<uint8_t>(_sideToMove | (_castlingRights << 1));
+    out[25] = static_cast<uint8_t>(_enPassantSquare == NO_SQUARE ? 64 : _enPassantSquare);
+    out[26] = static_cast<uint8_t>(std::min(_halfmoveClock, 255));
+    out[27] = static_cast<uint8_t>(_fullmoveNumber & 0xFF);
+    out[28] = static_cast<uint8_t>((_fullmoveNumber >> 8) & 0xFF);
+}
+
+// Set the board from its packed binary form
+bool Board::unpack(const uint8_t* in) {
+    Bitboard occupied = 0ULL;
+    for (int i = 0; i < 8; ++i) {
+        occupied |= static_cast<Bitboard>(in[i]) << (8 * i);
+    }
+    if (BitboardUtils::popCount(occupied) > 32 || in[24] > 31 || in[25] > 64) {
+        return false;
+    }
+    
+    // Decode into temporaries so a rejected position leaves the board as it was
+    Bitboard pieces[2][6] = {};
+    int index = 0;
+    for (; occupied; occupied &= occupied - 1) {
+        int code = (in[8 + index / 2] >> (4 * (index % 2))) & 0xF;
+        if (code >= 12) {
+            return false;
+        }
+        pieces[code / 6][code % 6] |= occupied & (~occupied + 1);
+        index++;
+    }
+    if (BitboardUtils::popCount(pieces[WHITE][KING]) != 1 || BitboardUtils::popCount(pieces[BLACK][KING]) != 1) {
+        return false;
+    }
+    
+    // An en passant square lies behind a pawn that has just made a double step
+    Color sideToMove = static_cast<Color>(in[24] & 1);
+    Square enPassant = in[25] == 64 ? NO_SQUARE : static_cast<Square>(in[25]);
+    if (enPassant != NO_SQUARE) {
+        Rank expected = sideToMove == WHITE ? RANK_6 : RANK_3;
+        Square pawn = static_cast<Square>(sideToMove == WHITE ? enPassant - 8 : enPassant + 8);
+        if (BitboardUtils::squareRank(enPassant) != expected || !(pieces[1 - sideToMove][PAWN] & (1ULL << pawn))) {
+            return false;
+        }
+    }
+    
+    // Castling rights need the king and the rook on their starting squares
+    int castlingRights = in[24] >> 1;
+    const struct { int right; Color color; Square king; Square rook; } castlings[] = {
+        {WHITE_OO, WHITE, E1, H1}, {WHITE_OOO, WHITE, E1, A1},
+        {BLACK_OO, BLACK, E8, H8}, {BLACK_OOO, BLACK, E8, A8},
+    };
+    for (const auto& castling : castlings) {
+        if (!(pieces[castling.color][KING] & (1ULL << castling.king)) ||
+            !(pieces[castling.color][ROOK] & (1ULL << castling.rook))) {
+            castlingRights &= ~castling.right;
+        }
+    }
+    
+    for (int color = WHITE; color <= BLACK; ++color) {
+        for (int piece = PAWN; piece <= KING; ++piece) {
+            _pieces[color][piece] = pieces[color][piece];
+        }
+    }
+    _sideToMove = sideToMove;
+    _castlingRights = castlingRights;
+    _enPassantSquare = enPassant;
+    _halfmoveClock = in[26];
+    _fullmoveNumber = in[27] | (in[28] << 8);
+    
+    updateCombinedBitboards();
+    _hash = Zobrist::computeKey(*this);
+    _pawnHash = Zobrist::computePawnKey(*this);
+    Eval::computePsqt(*this, _psqt, _phase);
+    
     return true;
 }
 
@@ -2,9 +2,18 @@
 #define BOARD_H
 
 #include "bitboard.h"
+#include "zobrist.h"
+#include "evaluate.h"
 #include <string>
+#include <string_view>
 #include <vector>
 
+// Longest UCI move text: source, destination and promotion piece
+constexpr size_t MAX_UCI_MOVE_LENGTH = 5;
+
+// Size of a position in its packed binary form
+constexpr size_t PACKED_BOARD_SIZE = 32;
+
 // A struct to represent a chess move
 struct Move {
     Square from;
@@ -22,13 +31,35 @@ struct Move {
     // Convert move to UCI string
     std::string toUci() const;
     
+    // Write the UCI text into a buffer of MAX_UCI_MOVE_LENGTH characters
+    // (not terminated) and return its length
+    size_t toUci(char* buffer) const;
+    
     // Create move from UCI string
-    static Move fromUci(const std::string& uci);
+    static Move fromUci(std::string_view uci);
     
     // Check if move is valid
     bool isValid() const {
         return from != NO_SQUARE && to != NO_SQUARE;
     }
+    
+    // Pack move into 16 bits (0 for an invalid move)
+    uint16_t pack() const {
+        if (!isValid()) {
+            return 0;
+        }
+        return static_cast<uint16_t>(from | (to << 6) | (promotion << 12));
+    }
+    
+    // Create move from its packed 16-bit form
+    static Move unpack(uint16_t packed) {
+        if (packed == 0) {
+            return Move();
+        }
+        return Move(static_cast<Square>(packed & 0x3F),
+                    static_cast<Square>((packed >> 6) & 0x3F),
+                    static_cast<PieceType>((packed >> 12) & 0x7));
+    }
 };
 
 // Castling rights
@@ -53,6 +84,22 @@ public:
     // Get FEN string representing current position
     std::string getFen() const;
     
+    // Write the position in PACKED_BOARD_SIZE bytes:
+    //   0-7    occupied squares (little endian bitboard)
+    //   8-23   a 4-bit code per occupied square in square order, low nibble first
+    //          (white pieces 0-5 and black pieces 6-11, in PieceType order)
+    //   24     side to move (bit 0, set for black) and castling rights (bits 1-4)
+    //   25     en passant square (64 for none)
+    //   26     halfmove clock (at most 255)
+    //   27-28  fullmove number (little endian)
+    //   29-31  zero
+    void pack(uint8_t* out) const;
+    
+    // Setup the board from its packed form; false, leaving the board unchanged, if it
+    // isn't a position with at most 32 pieces, one king per side and an en passant
+    // square behind a pawn. Castling rights without the king and rook at home are dropped.
+    bool unpack(const uint8_t* in);
+    
     // Reset board to starting position
     void reset();
 
@@ -61,6 +108,9 @@ public:
     // Make a move on the board
     bool makeMove(const Move& move);
     
+    // Pass the turn to the opponent without moving (used by null-move pruning)
+    void makeNullMove();
+    
     // Generate all legal moves
     std::vector<Move> generateLegalMoves() const;
     
@@ -97,6 +147,15 @@ public:
     // Check if the king of a given color is in check
     bool isInCheck(Color color) const;
     
+    // Check if a color has any pieces besides pawns and king
+    bool hasNonPawnMaterial(Color color) const;
+    
+    // Get the Zobrist hash key of the position
+    HashKey hash() const { return _hash; }
+    
+    // Get the Zobrist hash key of the pawns alone
+    HashKey pawnHash() const { return _pawnHash; }
+    
     // Print the board
     std::string toString() const;
     
@@ -127,6 +186,16 @@ public:
     // Chess960 mode
     bool _chess960;
     
+    // Zobrist hash key of the position
+    HashKey _hash;
+    
+    // Zobrist hash key of the pawn structure
+    HashKey _pawnHash;
+    
+    // Material and piece-square score (White's point of view) and game phase
+    Eval::Score _psqt;
+    int _phase;
+    
     // Helper method to find the king square for a given color
     Square findKing(Color color) const;
 private:
@@ -0,0 +1,78 @@
+#ifndef BOOK_H
+#define BOOK_H
+
+#include "board.h"
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+// Book file used when none is configured
+const char* const DEFAULT_BOOK_FILE = "book.bin";
+
+// Polyglot book keys, which use their own fixed random numbers rather than the engine's Zobrist keys
+namespace Polyglot {
+    // Compute the Polyglot key of a position
+    HashKey key(const Board& board);
+}
+
+// A move found in the book and its weight
+struct BookMove {
+    Move move;
+    uint16_t weight;
+};
+
+// Polyglot opening book (.bin), memory-mapped so that engine processes share it in the page cache
+class Book {
+public:
+    Book();
+    ~Book();
+
+    Book(const Book&) = delete;
+    Book& operator=(const Book&) = delete;
+
+    // Map a book file, replacing any book already open (false if it can't be used)
+    bool open(const std::string& filename);
+
+    // Unmap the book
+    void close();
+
+    // Check if a book is open
+    bool isOpen() const { return _data != nullptr; }
+
+    // Get the name of the open book file
+    const std::string& filename() const { return _filename; }
+
+    // Get the number of entries in the book
+    size_t size() const { return _entries; }
+
+    // Get the legal book moves for a position, in book order (highest weight first)
+    std::vector<BookMove> moves(const Board& board) const;
+
+    // Pick a book move at random in proportion to its weight (invalid when out of book, thread-safe)
+    Move probe(const Board& board, std::mt19937& rng) const;
+
+private:
+    // Size of a book entry: key, move, weight and learn fields, all big-endian
+    static constexpr size_t ENTRY_SIZE = 16;
+
+    // Key of the entry at an index
+    HashKey entryKey(size_t index) const;
+
+    // Convert a Polyglot move to one of the position's legal moves (invalid if it isn't legal)
+    static Move decodeMove(uint16_t bookMove, const Board& board, const std::vector<Move>& legalMoves);
+
+    const unsigned char* _data;
+
+    // Length of the file as mapped, and the whole entries it holds
+    size_t _mappedBytes;
+    size_t _entries;
+    std::string _filename;
+
+#ifdef _WIN32
+    // Without mmap the book is read into memory
+    std::vector<unsigned char> _buffer;
+#endif
+};
+
+#endif // BOOK_H
@@ -1,16 +1,18 @@
 #include "chess_rl.h"
+#include "bitbase.h"
 #include <limits>
 #include <algorithm>
+#include <map>
+#include <mutex>
 
 ChessRLAgent::ChessRLAgent(float epsilon, float alpha, float gamma) 
-    : explorationRate(epsilon), learningRate(alpha), discountFactor(gamma), maxReplayBufferSize(10000) {
-    
     // Initialize network with a topology appropriate for chess
     // Input: board features
     // Hidden layers: 2 layers with 256 and 128 neurons
     // Output: 1 value (position evaluation)
-    std::vector<int> topology = {static_cast<int>(BoardFeatureExtractor::getFeatureSize()), 256, 128, 1};
-    valueNetwork = std::make_unique<NeuralNetwork>(topology);
+    : valueNetwork(std::make_unique<NeuralNetwork>(valueNetworkTopology())),
+      explorationRate(epsilon), learningRate(alpha), discountFactor(gamma), maxReplayBufferSize(10000),
+      modelVersion(0), accumulator(*valueNetwork) {
     
     // Seed the random number generator
     std::random_device rd;
@@ -34,14 +36,16 @@ Move ChessRLAgent::selectMove(const Board& board, const std::vector<Move>& legal
     float bestValue = -std::numeric_limits<float>::infinity();
     Move bestMove = legalMoves[0]; // Default to first move
     
+    // The weights may have changed since the last call, so start from a fresh accumulator
+    accumulator.refresh(board);
+    
     for (const Move& move : legalMoves) {
         // Create a copy of the board and make the move
         Board boardCopy = board;
         boardCopy.makeMove(move);
         
-        // Extract features and evaluate the resulting position
-        std::vector<float> features = BoardFeatureExtractor::extractFeatures(boardCopy);
-        float value = valueNetwork->forward(features);
+        // Evaluate the resulting position
+        float value = evaluateChild(boardCopy);
         
         // Negate the value if it's black's turn (minimize for black)
         if (board.sideToMove() == BLACK) {
@@ -85,6 +89,12 @@ float ChessRLAgent::calculateReward(const Board& board, Color agentColor) {
         return 0.0f; // Neutral reward for draws
     }
     
+    // Endings the bitbases cover have a known result
+    Bitbases::WDL wdl;
+    if (Bitbases::probe(board, wdl)) {
+        return static_cast<float>(board.sideToMove() == agentColor ? wdl : -wdl);
+    }
+    
     // Small reward based on material balance
     float materialBalance = 0.0f;
     
@@ -109,19 +119,55 @@ float ChessRLAgent::calculateReward(const Board& board, Color agentColor) {
     return 0.01f * materialBalance; // Small incremental reward
 }
 
+uint64_t ChessRLAgent::evalCacheKey(const Board& board) {
+    // The network sees the halfmove clock, the Zobrist key doesn't
+    return board.hash() ^ (static_cast<uint64_t>(board.halfmoveClock()) * 0x9E3779B97F4A7C15ULL);
+}
+
+float ChessRLAgent::evaluatePosition(const Board& board, const std::vector<float>& features) {
+    float value;
+    uint64_t key = evalCacheKey(board);
+    if (evalCache.probe(key, modelVersion, value)) {
+        return value;
+    }
+    
+    value = valueNetwork->evaluate(features);
+    evalCache.store(key, modelVersion, value);
+    return value;
+}
+
+float ChessRLAgent::evaluateChild(const Board& child) {
+    float value;
+    uint64_t key = evalCacheKey(child);
+    if (evalCache.probe(key, modelVersion, value)) {
+        return value;
+    }
+    
+    // Only the features the move changed are applied to the first layer
+    accumulator.push(child);
+    value = accumulator.evaluate();
+    accumulator.pop();
+    
+    evalCache.store(key, modelVersion, value);
+    return value;
+}
+
 void ChessRLAgent::train(size_t batchSize) {
-    if (replayBuffer.size() < batchSize) return;
+    if (replayBuffer.size() < batchSize || replayBuffer.size() < 2) return;
+    
+    // The last transition has no next state to learn from, so it is never sampled
+    std::uniform_int_distribution<size_t> dist(0, replayBuffer.size() - 2);
     
-    std::uniform_int_distribution<size_t> dist(0, replayBuffer.size() - 1);
+    // Compute all targets with the weights as they were before this batch, so they
+    // can come from the evaluation cache, then apply the updates
+    std::vector<std::pair<size_t, float>> targets;
+    targets.reserve(batchSize);
     
     for (size_t i = 0; i < batchSize; i++) {
         // Sample a random transition from the replay buffer
         size_t idx = dist(rng);
         const GameState& state = replayBuffer[idx];
         
-        // Skip this sample if it's the last state in a game
-        if (idx == replayBuffer.size() - 1) continue;
-        
         // Get the next state
         const GameState& nextState = replayBuffer[idx + 1];
         
@@ -134,12 +180,21 @@ void ChessRLAgent::train(size_t batchSize) {
             targetValue = state.reward;
         } else {
             // Target = reward + gamma * V(next_state)
-            float nextStateValue = valueNetwork->forward(nextState.features);
+            float nextStateValue = evaluatePosition(nextState.board, nextState.features);
             targetValue = state.reward + discountFactor * nextStateValue;
         }
         
-        // Update the network
-        valueNetwork->backpropagate(state.features, targetValue, learningRate);
+        targets.push_back({idx, targetValue});
+    }
+    
+    // Update the network
+    for (const auto& [idx, targetValue] : targets) {
+        valueNetwork->backpropagate(replayBuffer[idx].features, targetValue, learningRate);
+    }
+    
+    // Evaluations by the old weights are stale now
+    if (!targets.empty()) {
+        modelVersion++;
     }
 }
 
@@ -155,19 +210,97 @@ void ChessRLAgent::save(const std::string& filename) {
 }
 
 bool ChessRLAgent::load(const std::string& filename) {
+    modelVersion++;
     return valueNetwork->load(filename);
 }
 
 Move modelBasedMove(const std::vector<Move>& legalMoves, const Board& board) {
     static ChessRLAgent agent; // Create a static agent so it persists between calls
+    static bool loadAttempted = false;
     static bool agentLoaded = false;
+
+    // The agent is shared by all engines of the process
+    static std::mutex agentMutex;
+    std::lock_guard<std::mutex> lock(agentMutex);
+        
+    // Load the model on the first call only, a missing file isn't looked for on every move
+    if (!loadAttempted) {
+        loadAttempted = true;
+        agentLoaded = agent.load(DEFAULT_MODEL_FILE);
+    }
         
-    // Try to load the agent if not already loaded
+    // Without a trained model, fall back to the handcrafted evaluation
     if (!agentLoaded) {
-        agentLoaded = agent.load("chess_rl_model.bin");
-        // If loading failed, we'll use the initial random weights
+        return staticEvalMove(legalMoves, board);
     }
         
     // Select a move using the RL agent
     return agent.selectMove(board, legalMoves);
 }
+
+Move staticEvalMove(const std::vector<Move>& legalMoves, const Board& board) {
+    if (legalMoves.empty()) {
+        return Move();
+    }
+    
+    int bestValue = std::numeric_limits<int>::min();
+    Move bestMove = legalMoves[0];
+    
+    for (const Move& move : legalMoves) {
+        Board boardCopy = board;
+        boardCopy.makeMove(move);
+        
+        // Mate ends the game, otherwise score the position from our side (the opponent is to move)
+        int value = boardCopy.isCheckmate() ? std::numeric_limits<int>::max() : -Eval::evaluate(boardCopy);
+        if (value > bestValue) {
+            bestValue = value;
+            bestMove = move;
+        }
+    }
+    
+    return bestMove;
+}
+
+std::vector<int> valueNetworkTopology() {
+    return {static_cast<int>(BoardFeatureExtractor::getFeatureSize()), 256, 128, 1};
+}
+
+std::shared_ptr<NeuralNetwork> loadValueNetwork(const std::string& filename) {
+    auto network = std::make_shared<NeuralNetwork>(valueNetworkTopology());
+    if (!network->load(filename)) {
+        return nullptr;
+    }
+    
+    // The file sets the topology; a network for other inputs can't score positions
+    if (network->inputSize() != BoardFeatureExtractor::getFeatureSize()) {
+        return nullptr;
+    }
+    return network;
+}
+
+std::shared_ptr<NeuralNetwork> sharedValueNetwork(const std::string& filename) {
+    static std::mutex cacheMutex;
+    static std::map<std::string, std::weak_ptr<NeuralNetwork>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_ptr<NeuralNetwork> network = cache[filename].lock();
+    if (!network) {
+        network = loadValueNetwork(filename);
+        cache[filename] = network;
+    }
+    return network;
+}
+
+LeafEvaluator networkEvaluator(std::shared_ptr<const NeuralNetwork> network) {
+    return [network](const Board& board) {
+        // The network scores positions from White's perspective
+        float value = network->evaluate(BoardFeatureExtractor::extractFeatures(board));
+        return board.sideToMove() == WHITE ? value : -value;
+    };
+}
+
+LeafEvaluator batchedNetworkEvaluator(std::shared_ptr<BatchEvaluator> batcher) {
+    return [batcher](const Board& board) {
+        return batcher->evaluate(board);
+    };
+}
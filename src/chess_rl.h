@@ -6,6 +6,10 @@
 #include <string>
 #include <unordered_map>
 #include "board.h"
+#include "mcts.h"
+#include "batch_evaluator.h"
+#include "eval_cache.h"
+#include "accumulator.h"
 #include "neural_network.h"
 #include "feature_extractor.h"
 
@@ -33,6 +37,22 @@ private:
     
     std::vector<GameState> replayBuffer;
     size_t maxReplayBufferSize;
+    
+    // Cached evaluations, tagged with the version of the weights that produced them
+    EvalCache evalCache;
+    uint32_t modelVersion;
+    
+    // First-layer pre-activations along the positions being scored, updated move by move
+    Accumulator accumulator;
+    
+    // Cache key of a position: everything the network sees, the halfmove clock included
+    static uint64_t evalCacheKey(const Board& board);
+    
+    // Value of a position from White's perspective, from the cache when possible
+    float evaluatePosition(const Board& board, const std::vector<float>& features);
+    
+    // Value of a position one move away from the accumulator's current ply
+    float evaluateChild(const Board& child);
 
 public:
     ChessRLAgent(float epsilon = 0.1, float alpha = 0.001, float gamma = 0.99);
@@ -43,7 +63,8 @@ public:
     // Record a state-action-reward transition
     void recordTransition(const Board& board, const Move& move, float reward);
     
-    // Calculate reward based on game outcome
+    // Calculate reward based on game outcome: +1, 0 or -1 for a finished game or an
+    // ending the bitbases decide, a small material term otherwise
     float calculateReward(const Board& board, Color agentColor);
     
     // Train the network using experience replay
@@ -57,7 +78,33 @@ public:
     
     // Load the agent from a file
     bool load(const std::string& filename);
+    
+    // Access the evaluation cache (for its hit rate)
+    const EvalCache& evaluationCache() const { return evalCache; }
+    EvalCache& evaluationCache() { return evalCache; }
 };
 
 // Declaration of the modelBasedMove function
 Move modelBasedMove(const std::vector<Move>& legalMoves, const Board& board);
+
+// Pick the move leading to the best handcrafted evaluation (fallback without a model, and training baseline)
+Move staticEvalMove(const std::vector<Move>& legalMoves, const Board& board);
+
+// Default file the trained value network is saved to and loaded from
+const char* const DEFAULT_MODEL_FILE = "chess_rl_model.bin";
+
+// Topology of the value network used by the agent
+std::vector<int> valueNetworkTopology();
+
+// Load a value network from a file (nullptr if there is no usable model)
+std::shared_ptr<NeuralNetwork> loadValueNetwork(const std::string& filename = DEFAULT_MODEL_FILE);
+
+// Value network of a file loaded once and shared by every engine of the process while
+// any of them uses it (nullptr if there is no usable model, thread-safe)
+std::shared_ptr<NeuralNetwork> sharedValueNetwork(const std::string& filename = DEFAULT_MODEL_FILE);
+
+// Leaf evaluator for the tree search backed by a value network
+LeafEvaluator networkEvaluator(std::shared_ptr<const NeuralNetwork> network);
+
+// Leaf evaluator that queues positions for batched evaluation
+LeafEvaluator batchedNetworkEvaluator(std::shared_ptr<BatchEvaluator> batcher);
@@ -0,0 +1,682 @@
+#include "cli.h"
+#include "bench.h"
+#include "bitbase.h"
+#include "engine.h"
+#include "epd.h"
+#include "mate.h"
+#include "server.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <deque>
+#include <mutex>
+
+#ifdef ENABLE_RL
+#include "batch_protocol.h"
+#include "chess_rl.h"
+#endif
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+    // Settings given to a mode as "name value" pairs
+    struct ModeOptions {
+        SearchLimits limits;
+        int moves = DEFAULT_PUZZLE_MATE_MOVES;
+        int threads = 1;
+        size_t hashMb = DEFAULT_ANALYSIS_HASH_MB;
+        std::string format = "csv";
+        std::string model;
+        size_t batch = 0;
+    };
+
+    // Read the "name value" pairs following the mode's positional arguments,
+    // accepting only the names the mode lists
+    bool parseOptions(const std::vector<std::string>& args, size_t first,
+                      const std::vector<std::string>& allowed, ModeOptions& options) {
+        for (size_t i = first; i + 1 < args.size(); i += 2) {
+            if (std::find(allowed.begin(), allowed.end(), args[i]) == allowed.end()) {
+                std::cerr << "Unknown option " << args[i] << std::endl;
+                return false;
+            }
+
+            std::istringstream value(args[i + 1]);
+            if (args[i] == "moves") {
+                value >> options.moves;
+            } else if (args[i] == "depth") {
+                value >> options.limits.depth;
+                options.limits.depth = std::min(options.limits.depth, MAX_PLY - 1);
+            } else if (args[i] == "nodes") {
+                value >> options.limits.nodes;
+            } else if (args[i] == "movetime") {
+                value >> options.limits.moveTime;
+            } else if (args[i] == "threads") {
+                value >> options.threads;
+                options.threads = std::max(options.threads, 1);
+            } else if (args[i] == "hash") {
+                value >> options.hashMb;
+            } else if (args[i] == "format") {
+                value >> options.format;
+                if (options.format != "csv" && options.format != "json") {
+                    value.setstate(std::ios::failbit);
+                }
+            } else if (args[i] == "model") {
+                value >> options.model;
+            } else if (args[i] == "batch") {
+                value >> options.batch;
+                if (options.batch == 0) {
+                    value.setstate(std::ios::failbit);
+                }
+            }
+            if (value.fail()) {
+                std::cerr << "Invalid value for " << args[i] << ": " << args[i + 1] << std::endl;
+                return false;
+            }
+        }
+        return (args.size() - first) % 2 == 0;
+    }
+
+    // Open a mode's input file, "-" standing for standard input
+    bool openInput(const std::string& path, std::ifstream& file) {
+        if (path != "-") {
+            file.open(path);
+            if (!file.is_open()) {
+                std::cerr << "Could not open " << path << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Searches of the batch modes use the bitbases like the engine does
+    void loadBitbases() {
+        if (Bitbases::maxPieces() == 0) {
+            Bitbases::load(DEFAULT_BITBASE_DIRECTORY);
+        }
+    }
+
+    // The position fields of a FEN, as written at the start of an EPD line
+    std::string epdPosition(const std::string& fen) {
+        std::istringstream is(fen);
+        std::string fields[4];
+        is >> fields[0] >> fields[1] >> fields[2] >> fields[3];
+        return fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3];
+    }
+
+    int runMate(const std::vector<std::string>& args) {
+        if (args.size() < 2) {
+            std::cerr << "Usage: bitchess mate <file|-> [moves <n>] [nodes <n>] [movetime <ms>]" << std::endl;
+            return 1;
+        }
+
+        ModeOptions options;
+        if (!parseOptions(args, 2, {"moves", "nodes", "movetime"}, options)) {
+            return 1;
+        }
+        const SearchLimits& limits = options.limits;
+
+        std::ifstream file;
+        if (!openInput(args[1], file)) {
+            return 1;
+        }
+        std::istream& in = args[1] == "-" ? std::cin : file;
+
+        MateSolver solver;
+        int puzzles = 0;
+        int solved = 0;
+        uint64_t totalNodes = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        std::string line;
+        while (std::getline(in, line)) {
+            EpdRecord record;
+            if (!parseEpd(line, record)) {
+                continue;
+            }
+            Board board;
+            if (!board.setFromFen(record.fen)) {
+                std::cerr << "Invalid position: " << line << std::endl;
+                continue;
+            }
+
+            // A dm operation gives the expected mate length
+            int moves = options.moves;
+            if (const std::string* dm = record.operation("dm")) {
+                moves = std::max(1, std::atoi(dm->c_str()));
+            }
+
+            MateResult result = solver.solve(board, moves, limits);
+            puzzles++;
+            totalNodes += result.nodes;
+
+            std::ostringstream out;
+            out << epdPosition(record.fen);
+            if (const std::string* id = record.operation("id")) {
+                out << " id \"" << *id << "\";";
+            }
+            if (result.found) {
+                solved++;
+                out << " bm " << result.pv[0].toUci() << "; dm " << result.moves << "; pv \"";
+                for (size_t i = 0; i < result.pv.size(); ++i) {
+                    out << (i > 0 ? " " : "") << result.pv[i].toUci();
+                }
+                out << "\";";
+            } else {
+                out << " c0 \"" << (result.disproven ? "no mate" : "unsolved") << " in " << moves << "\";";
+            }
+            out << " acn " << result.nodes << ";";
+            std::cout << out.str() << std::endl;
+        }
+
+        int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cerr << "Solved " << solved << " of " << puzzles << " puzzles, " << totalNodes
+                  << " nodes in " << elapsedMs << " ms" << std::endl;
+        return 0;
+    }
+
+    // Score as centipawns, or as "#n" / "#-n" for a mate in n moves for or against the side to move
+    std::string scoreText(int score) {
+        if (score >= VALUE_MATE_IN_MAX_PLY) {
+            return "#" + std::to_string((VALUE_MATE - score + 1) / 2);
+        }
+        if (score <= -VALUE_MATE_IN_MAX_PLY) {
+            // A position that is already checkmate is mated in zero moves
+            int moves = (VALUE_MATE + score) / 2;
+            return moves == 0 ? "#0" : "#-" + std::to_string(moves);
+        }
+        return std::to_string(score);
+    }
+
+    std::string pvText(const std::vector<Move>& pv) {
+        std::string text;
+        for (const Move& move : pv) {
+            text += (text.empty() ? "" : " ") + move.toUci();
+        }
+        return text;
+    }
+
+    // Quote a CSV field if it contains a separator or a quote
+    std::string csvField(const std::string& text) {
+        if (text.find_first_of(",\"\n") == std::string::npos) {
+            return text;
+        }
+        std::string quoted = "\"";
+        for (char c : text) {
+            quoted += c == '"' ? "\"\"" : std::string(1, c);
+        }
+        return quoted + "\"";
+    }
+
+    std::string jsonString(const std::string& text) {
+        std::string escaped = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                escaped += ' ';
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped + "\"";
+    }
+
+    // A position being analyzed and what the search found
+    struct Analysis {
+        EpdRecord record;
+        bool valid = false;
+        bool done = false;
+        SearchResult result;
+        int64_t timeMs = 0;
+    };
+
+    void analyzePosition(Search& search, const SearchLimits& limits, Analysis& analysis) {
+        Board board;
+        if (!board.setFromFen(analysis.record.fen)) {
+            return;
+        }
+        analysis.valid = true;
+
+        // The game is over: no move, and the score of a mate or a draw
+        if (board.generateLegalMoves().empty()) {
+            analysis.result.score = board.isCheckmate() ? -VALUE_MATE : 0;
+            return;
+        }
+
+        // The table is kept: entries of earlier positions age out, and
+        // clearing it would cost more than a shallow search
+        auto searchStart = std::chrono::steady_clock::now();
+        analysis.result = search.run(board, limits);
+        analysis.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - searchStart).count();
+    }
+
+    void writeAnalysis(std::ostream& out, const Analysis& analysis, bool json) {
+        const std::string* id = analysis.record.operation("id");
+        const SearchResult& result = analysis.result;
+        if (json) {
+            out << "{\"fen\":" << jsonString(analysis.record.fen);
+            if (id) {
+                out << ",\"id\":" << jsonString(*id);
+            }
+            out << ",\"bestmove\":\"" << (result.bestMove.isValid() ? result.bestMove.toUci() : "") << "\"";
+            if (std::abs(result.score) >= VALUE_MATE_IN_MAX_PLY) {
+                int moves = result.score > 0 ? (VALUE_MATE - result.score + 1) / 2 : -(VALUE_MATE + result.score) / 2;
+                out << ",\"mate\":" << moves;
+            } else {
+                out << ",\"cp\":" << result.score;
+            }
+            out << ",\"depth\":" << result.depth << ",\"nodes\":" << result.nodes
+                << ",\"time\":" << analysis.timeMs << ",\"pv\":\"" << pvText(result.pv) << "\"}\n";
+        } else {
+            out << analysis.record.fen << "," << (id ? csvField(*id) : "") << ","
+                << (result.bestMove.isValid() ? result.bestMove.toUci() : "")
+                << "," << scoreText(result.score) << "," << result.depth << "," << result.nodes
+                << "," << analysis.timeMs << "," << pvText(result.pv) << "\n";
+        }
+    }
+
+    int runAnalyze(const std::vector<std::string>& args) {
+        if (args.size() < 2) {
+            std::cerr << "Usage: bitchess analyze <file|-> [depth <n>] [nodes <n>] [movetime <ms>] "
+                         "[threads <n>] [hash <mb>] [format csv|json]" << std::endl;
+            return 1;
+        }
+
+        ModeOptions options;
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+        options.limits.depth = 0;
+        if (!parseOptions(args, 2, {"depth", "nodes", "movetime", "threads", "hash", "format"}, options)) {
+            return 1;
+        }
+        SearchLimits limits = options.limits;
+        if (limits.depth <= 0) {
+            // Without any budget, search to the default depth
+            bool budget = limits.nodes > 0 || limits.moveTime > 0;
+            limits.depth = budget ? MAX_PLY - 1 : DEFAULT_SEARCH_DEPTH;
+        }
+        bool json = options.format == "json";
+
+        std::ifstream file;
+        if (!openInput(args[1], file)) {
+            return 1;
+        }
+        std::istream& in = args[1] == "-" ? std::cin : file;
+
+        loadBitbases();
+
+        // One search (and transposition table) per worker, taken by a task while it runs
+        std::vector<std::unique_ptr<Search>> searches;
+        std::vector<Search*> idle;
+        for (int i = 0; i < options.threads; ++i) {
+            searches.push_back(std::make_unique<Search>());
+            searches.back()->setHashSize(options.hashMb);
+            idle.push_back(searches.back().get());
+        }
+
+        if (!json) {
+            std::cout << "fen,id,bestmove,score,depth,nodes,time,pv\n";
+        }
+
+        size_t analyzed = 0;
+        uint64_t totalNodes = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        // Positions read but not written yet, in input order. Each finished task writes the
+        // finished positions at the front, so a slow position only holds back the output
+        // while the other workers keep searching the positions read ahead.
+        std::deque<Analysis> pending;
+        const size_t readAhead = DEFAULT_ANALYSIS_BATCH * searches.size();
+        std::mutex mutex;
+        std::condition_variable written;
+
+        ThreadPool pool(searches.size());
+        std::string line;
+        while (std::getline(in, line)) {
+            EpdRecord record;
+            if (!parseEpd(line, record)) {
+                continue;
+            }
+
+            Analysis* analysis;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                written.wait(lock, [&]() { return pending.size() < readAhead; });
+                pending.emplace_back();
+                analysis = &pending.back();
+                analysis->record = std::move(record);
+            }
+
+            pool.submit([&, analysis]() {
+                Search* search;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    search = idle.back();
+                    idle.pop_back();
+                }
+
+                analyzePosition(*search, limits, *analysis);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                idle.push_back(search);
+                analysis->done = true;
+                while (!pending.empty() && pending.front().done) {
+                    const Analysis& front = pending.front();
+                    if (front.valid) {
+                        writeAnalysis(std::cout, front, json);
+                        analyzed++;
+                        totalNodes += front.result.nodes;
+                    } else {
+                        std::cerr << "Invalid position: " << front.record.fen << std::endl;
+                    }
+                    pending.pop_front();
+                }
+                std::cout.flush();
+                written.notify_all();
+            });
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            written.wait(lock, [&]() { return pending.empty(); });
+        }
+
+        int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cerr << "Analyzed " << analyzed << " positions, " << totalNodes << " nodes in " << elapsedMs
+                  << " ms (" << totalNodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(elapsedMs, 1))
+                  << " nps)" << std::endl;
+        return 0;
+    }
+
+    // A test position and how the search did on it
+    struct SuiteEntry {
+        EpdRecord record;
+        Board board;
+        std::vector<Move> bestMoves;
+        std::vector<Move> avoidMoves;
+        Move found;
+        bool solved = false;
+
+        // Time and nodes at the iteration from which on the move was right
+        int64_t solveMs = 0;
+        uint64_t solveNodes = 0;
+        uint64_t nodes = 0;
+
+        bool correct(const Move& move) const {
+            bool best = bestMoves.empty() || std::find(bestMoves.begin(), bestMoves.end(), move) != bestMoves.end();
+            bool avoided = std::find(avoidMoves.begin(), avoidMoves.end(), move) != avoidMoves.end();
+            return move.isValid() && best && !avoided;
+        }
+    };
+
+    void runSuiteEntry(Search& search, const SearchLimits& limits, SuiteEntry& entry) {
+        bool found = false;
+        search.setInfoCallback([&entry, &found](const SearchInfo& info) {
+            if (info.progress || info.multiPv != 1 || info.pv.empty()) {
+                return;
+            }
+            if (!entry.correct(info.pv[0])) {
+                found = false;
+            } else if (!found) {
+                found = true;
+                entry.solveMs = info.timeMs;
+                entry.solveNodes = info.nodes;
+            }
+        });
+
+        search.clear();
+        auto searchStart = std::chrono::steady_clock::now();
+        SearchResult result = search.run(entry.board, limits);
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - searchStart).count();
+        search.setInfoCallback(nullptr);
+
+        entry.found = result.bestMove;
+        entry.nodes = result.nodes;
+        entry.solved = entry.correct(result.bestMove);
+        if (entry.solved && !found) {
+            entry.solveMs = elapsedMs;
+            entry.solveNodes = result.nodes;
+        }
+    }
+
+    int runSuite(const std::vector<std::string>& args) {
+        if (args.size() < 2) {
+            std::cerr << "Usage: bitchess suite <file|-> [movetime <ms>] [nodes <n>] [depth <n>] "
+                         "[threads <n>] [hash <mb>]" << std::endl;
+            return 1;
+        }
+
+        ModeOptions options;
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+        if (!parseOptions(args, 2, {"movetime", "nodes", "depth", "threads", "hash"}, options)) {
+            return 1;
+        }
+        SearchLimits limits = options.limits;
+        if (limits.moveTime <= 0 && limits.nodes == 0 && limits.depth >= MAX_PLY - 1) {
+            limits.moveTime = DEFAULT_SUITE_MOVETIME_MS;
+        }
+
+        std::ifstream file;
+        if (!openInput(args[1], file)) {
+            return 1;
+        }
+        std::istream& in = args[1] == "-" ? std::cin : file;
+
+        // Test positions are the ones with a best or avoid move
+        std::vector<SuiteEntry> entries;
+        std::string line;
+        while (std::getline(in, line)) {
+            SuiteEntry entry;
+            if (!parseEpd(line, entry.record)) {
+                continue;
+            }
+            const std::string* bm = entry.record.operation("bm");
+            const std::string* am = entry.record.operation("am");
+            bool valid = entry.board.setFromFen(entry.record.fen) && (bm || am) &&
+                         (!bm || parseEpdMoves(entry.board, *bm, entry.bestMoves)) &&
+                         (!am || parseEpdMoves(entry.board, *am, entry.avoidMoves));
+            if (!valid) {
+                std::cerr << "Skipping " << line << std::endl;
+                continue;
+            }
+            entries.push_back(std::move(entry));
+        }
+
+        loadBitbases();
+
+        auto start = std::chrono::steady_clock::now();
+        std::atomic<size_t> next(0);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < options.threads; ++t) {
+            workers.emplace_back([&entries, &next, &limits, &options]() {
+                auto search = std::make_unique<Search>();
+                search->setHashSize(options.hashMb);
+                for (size_t i = next++; i < entries.size(); i = next++) {
+                    runSuiteEntry(*search, limits, entries[i]);
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        int solved = 0;
+        int64_t totalSolveMs = 0;
+        uint64_t totalSolveNodes = 0;
+        uint64_t totalNodes = 0;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const SuiteEntry& entry = entries[i];
+            const std::string* id = entry.record.operation("id");
+            const std::string* bm = entry.record.operation("bm");
+            std::cout << (id ? *id : std::to_string(i + 1)) << ": " << (entry.solved ? "solved" : "unsolved")
+                      << (bm ? " bm " : " am ") << *(bm ? bm : entry.record.operation("am"))
+                      << ", played " << entry.found.toUci();
+            if (entry.solved) {
+                solved++;
+                totalSolveMs += entry.solveMs;
+                totalSolveNodes += entry.solveNodes;
+                std::cout << " after " << entry.solveMs << " ms, " << entry.solveNodes << " nodes";
+            }
+            std::cout << "\n";
+            totalNodes += entry.nodes;
+        }
+
+        int total = static_cast<int>(entries.size());
+        std::cout << "Solved " << solved << " of " << total << " ("
+                  << (total > 0 ? 100 * solved / total : 0) << "%)\n";
+        if (solved > 0) {
+            std::cout << "Time to solve: " << totalSolveMs << " ms total, " << totalSolveMs / solved << " ms average\n"
+                      << "Nodes to solve: " << totalSolveNodes << " total, " << totalSolveNodes / solved << " average\n";
+        }
+        std::cout << "Searched " << totalNodes << " nodes in " << elapsedMs << " ms with " << options.threads
+                  << " threads" << std::endl;
+        return 0;
+    }
+
+    // Set by SIGINT and SIGTERM to shut the server down cleanly
+    std::atomic<bool> serverInterrupted(false);
+
+    int runServe(const std::vector<std::string>& args) {
+        if (args.size() < 2) {
+            std::cerr << "Usage: bitchess serve <unix:path|port> [threads <n>]" << std::endl;
+            return 1;
+        }
+
+        ModeOptions options;
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+        if (!parseOptions(args, 2, {"threads"}, options)) {
+            return 1;
+        }
+
+        Server server(static_cast<size_t>(options.threads));
+        if (!server.listen(args[1])) {
+            return 1;
+        }
+
+        // The sessions share the bitbases, so they are loaded once before any of them can search
+        loadBitbases();
+        std::cerr << "Serving UCI sessions on " << args[1] << " with " << options.threads
+                  << " search threads" << std::endl;
+
+        std::signal(SIGINT, [](int) { serverInterrupted = true; });
+        std::signal(SIGTERM, [](int) { serverInterrupted = true; });
+        std::thread acceptor(&Server::run, &server);
+        while (!serverInterrupted) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(SERVER_POLL_INTERVAL_MS));
+        }
+        server.stop();
+        acceptor.join();
+        return 0;
+    }
+
+    int runEvaluate(const std::vector<std::string>& args) {
+        if (args.size() < 2 || (args[1] != "value" && args[1] != "move")) {
+            std::cerr << "Usage: bitchess evaluate <value|move> [model <file>] [batch <n>]" << std::endl;
+            return 1;
+        }
+
+        ModeOptions options;
+        if (!parseOptions(args, 2, {"model", "batch"}, options)) {
+            return 1;
+        }
+
+#ifdef ENABLE_RL
+        std::shared_ptr<NeuralNetwork> network = loadValueNetwork(options.model.empty() ? DEFAULT_MODEL_FILE : options.model);
+        if (!network) {
+            std::cerr << "Could not load a value network from "
+                      << (options.model.empty() ? DEFAULT_MODEL_FILE : options.model) << std::endl;
+            return 1;
+        }
+
+        // Positions and results are raw bytes, and standard input gets its own buffer
+        // so the protocol can see how many positions have arrived
+        std::ios::sync_with_stdio(false);
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+        ProtocolResult result = args[1] == "value" ? ProtocolResult::Value : ProtocolResult::MoveAndScore;
+        BatchProtocol protocol(*network, result, options.batch > 0 ? options.batch : DEFAULT_PROTOCOL_BATCH_SIZE);
+        uint64_t positions = protocol.run(std::cin, std::cout);
+        std::cerr << "Evaluated " << positions << " positions in " << protocol.batchCount() << " batches" << std::endl;
+        return 0;
+#else
+        std::cerr << "The evaluate mode needs the value network of the RL build (bitchess_rl)" << std::endl;
+        return 1;
+#endif
+    }
+
+    int runBench(const std::vector<std::string>& args) {
+        int depth = DEFAULT_BENCH_DEPTH;
+        if (args.size() > 1) {
+            depth = std::atoi(args[1].c_str());
+            if (depth < 1 || depth >= MAX_PLY) {
+                std::cerr << "Usage: bitchess bench [depth]" << std::endl;
+                return 1;
+            }
+        }
+
+        size_t count = Bench::positions().size();
+        BenchResult total = Bench::run(depth, [count](size_t index, const std::string& fen, const SearchResult& result) {
+            std::cerr << "Position " << index + 1 << "/" << count << ": " << fen << "\n  bestmove "
+                      << result.bestMove.toUci() << " score " << result.score << " nodes " << result.nodes << std::endl;
+        });
+
+        std::cout << "Total time (ms) : " << total.timeMs << "\n"
+                  << "Nodes searched  : " << total.nodes << "\n"
+                  << "Nodes/second    : " << total.nps() << std::endl;
+        return 0;
+    }
+}
+
+namespace Cli {
+    int run(int argc, char* argv[]) {
+        std::vector<std::string> args(argv + 1, argv + argc);
+        if (args.empty()) {
+            return 1;
+        }
+
+        if (args[0] == "mate") {
+            return runMate(args);
+        }
+        if (args[0] == "bench") {
+            return runBench(args);
+        }
+        if (args[0] == "analyze") {
+            return runAnalyze(args);
+        }
+        if (args[0] == "suite") {
+            return runSuite(args);
+        }
+        if (args[0] == "serve") {
+            return runServe(args);
+        }
+        if (args[0] == "evaluate") {
+            return runEvaluate(args);
+        }
+
+        std::cerr << "Unknown mode " << args[0] << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef CLI_H
+#define CLI_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Mate length tried for puzzles that don't give one with a dm operation
+constexpr int DEFAULT_PUZZLE_MATE_MOVES = 5;
+
+// Transposition table size of each analysis worker
+constexpr size_t DEFAULT_ANALYSIS_HASH_MB = 16;
+
+// Search time per test position when the suite is given no budget
+constexpr int64_t DEFAULT_SUITE_MOVETIME_MS = 1000;
+
+// Positions read ahead per analysis worker, waiting to be searched or for earlier results to be written
+constexpr size_t DEFAULT_ANALYSIS_BATCH = 64;
+
+// Command-line modes, run instead of the UCI loop when bitchess is given arguments:
+//
+//   bitchess mate <file|-> [moves <n>] [nodes <n>] [movetime <ms>]
+//       Solve the mate puzzles of a FEN/EPD file, writing one EPD line per puzzle
+//       with the mating move (bm), the mate length (dm), the line (pv) and the nodes (acn)
+//
+//   bitchess analyze <file|-> [depth <n>] [nodes <n>] [movetime <ms>] [threads <n>] [hash <mb>] [format csv|json]
+//       Search every FEN/EPD position of a file on a pool of worker threads and write the
+//       best move, score and pv of each, in input order, as CSV rows or JSON lines; a
+//       checkmate or stalemate gets a row with no best move and a mate or draw score
+//
+//   bitchess suite <file|-> [movetime <ms>] [nodes <n>] [depth <n>] [threads <n>] [hash <mb>]
+//       Run an EPD test suite: search each position with a bm or am operation in parallel
+//       and report whether it was solved, the time and nodes from which on the right move
+//       was played, and totals
+//
+//   bitchess serve <unix:path|port> [threads <n>]
+//       Serve UCI sessions over a Unix domain socket or a localhost TCP port until
+//       interrupted, sharing the model, bitbases and books and one pool of search threads
+//
+//   bitchess evaluate <value|move> [model <file>] [batch <n>]
+//       Score positions streamed in packed binary form on standard input with the
+//       value network (RL build only), writing a packed value, or best move and
+//       value, per position to standard output (see BatchProtocol)
+//
+//   bitchess bench [depth]
+//       Search the built-in bench positions and print the total nodes (a signature
+//       of the search) and the nodes per second
+namespace Cli {
+    // Run the mode named by the arguments and return the process exit code
+    int run(int argc, char* argv[]);
+}
+
+#endif // CLI_H
@@ -3,21 +3,30 @@
 #include <random>
 #include <chrono>
 
-Engine::Engine() : _rng(std::chrono::system_clock::now().time_since_epoch().count()) {
+Engine::Engine() : _strategy(EngineStrategy::SelectionFunction), _ownBook(false), _rng(std::chrono::system_clock::now().time_since_epoch().count()) {
 	// Set default move selection strategy to random
 	//_moveSelectionStrategy = std::bind(&Engine::randomMove, std::placeholders::_1, std::placeholders::_2);
 #ifdef ENABLE_RL
 	_moveSelectionStrategy = std::bind(&modelBasedMove, std::placeholders::_1, std::placeholders::_2);
+
+	// The tree search evaluates leaves with the trained value network if there is one,
+	// and with the handcrafted evaluation otherwise
+	_valueNetwork = sharedValueNetwork();
+	if (_valueNetwork) {
+		_mcts.setEvaluator(networkEvaluator(_valueNetwork));
+	}
 #else
 	_moveSelectionStrategy = std::bind(&Engine::weightedRandomMove, std::placeholders::_1, std::placeholders::_2);
+	_strategy = EngineStrategy::AlphaBeta;
 #endif
 
 	// Initialize board to starting position
 	_board.reset();
 }
 
-void Engine::setPosition(const Board& board) {
+void Engine::setPosition(const Board& board, const std::vector<HashKey>& history) {
 	_board = board;
+	_gameHistory = history;
 }
 
 const Board& Engine::getPosition() const {
@@ -25,6 +34,14 @@ const Board& Engine::getPosition() const {
 }
 
 Move Engine::makeMove() {
+	SearchLimits limits;
+	limits.depth = DEFAULT_SEARCH_DEPTH;
+	return makeMove(limits);
+}
+
+Move Engine::makeMove(const SearchLimits& limits) {
+	_ponderMove = Move();
+
 	// Generate legal moves
 	std::vector<Move> legalMoves = _board.generateLegalMoves();
 
@@ -33,10 +50,55 @@ Move Engine::makeMove() {
 		return Move(); // Return invalid move if no legal moves
 	}
 
-	// Select a move using the current strategy
-	Move selectedMove = _moveSelectionStrategy(legalMoves, _board);
+	// Book moves are played instantly
+	if (_ownBook && _book.isOpen()) {
+		Move bookMove = _book.probe(_board, _rng);
+		if (bookMove.isValid()) {
+			_gameHistory.push_back(_board.hash());
+			_board.makeMove(bookMove);
+			return bookMove;
+		}
+	}
+
+	// Mate searches go to the proof-number solver first, the strategy only
+	// runs if it can't prove a mate
+	if (limits.mate > 0) {
+		MateResult mate = _mateSolver.solve(_board, limits.mate, limits);
+		if (mate.found && !mate.pv.empty()) {
+			if (_infoCallback) {
+				SearchInfo info;
+				info.depth = 2 * mate.moves - 1;
+				info.selDepth = static_cast<int>(mate.pv.size());
+				info.score = VALUE_MATE - (2 * mate.moves - 1);
+				info.nodes = mate.nodes;
+				info.timeMs = mate.timeMs;
+				info.pv = mate.pv;
+				_infoCallback(info);
+			}
+			_ponderMove = mate.pv.size() > 1 ? mate.pv[1] : Move();
+			_gameHistory.push_back(_board.hash());
+			_board.makeMove(mate.pv[0]);
+			return mate.pv[0];
+		}
+	}
+
+	// Select a move using one of the searches or the current strategy
+	Move selectedMove;
+	if (_strategy == EngineStrategy::AlphaBeta) {
+		_search.setGameHistory(_gameHistory);
+		SearchResult result = _search.run(_board, limits);
+		selectedMove = result.bestMove;
+		_ponderMove = result.ponderMove;
+	} else if (_strategy == EngineStrategy::MonteCarlo) {
+		SearchResult result = _mcts.run(_board, limits);
+		selectedMove = result.bestMove;
+		_ponderMove = result.ponderMove;
+	} else {
+		selectedMove = _moveSelectionStrategy(legalMoves, _board);
+	}
 
 	// Make the selected move on the board
+	_gameHistory.push_back(_board.hash());
 	_board.makeMove(selectedMove);
 
 	return selectedMove;
@@ -44,6 +106,56 @@ Move Engine::makeMove() {
 
 void Engine::setMoveSelectionStrategy(MoveSelectionFunc strategy) {
 	_moveSelectionStrategy = strategy;
+	_strategy = EngineStrategy::SelectionFunction;
+}
+
+void Engine::useSearch() {
+	_strategy = EngineStrategy::AlphaBeta;
+}
+
+#ifdef ENABLE_RL
+void Engine::setEvalBatching(size_t batchSize, int64_t maxLatencyUs) {
+	if (!_valueNetwork) {
+		return;
+	}
+
+	if (batchSize <= 1) {
+		_mcts.setEvaluator(networkEvaluator(_valueNetwork));
+	} else {
+		auto batcher = std::make_shared<BatchEvaluator>(_valueNetwork, batchSize,
+		                                                std::chrono::microseconds(maxLatencyUs));
+		_mcts.setEvaluator(batchedNetworkEvaluator(batcher));
+	}
+}
+#endif
+
+void Engine::setInfoCallback(SearchInfoCallback callback) {
+	_infoCallback = callback;
+	_search.setInfoCallback(callback);
+	_mcts.setInfoCallback(callback);
+}
+
+void Engine::setMoveOverhead(int64_t overheadMs) {
+	_search.timeManager().setMoveOverhead(overheadMs);
+	_mateSolver.timeManager().setMoveOverhead(overheadMs);
+	_mcts.timeManager().setMoveOverhead(overheadMs);
+}
+
+void Engine::stop() {
+	_search.stop();
+	_mateSolver.stop();
+	_mcts.stop();
+}
+
+void Engine::ponderhit() {
+	_search.ponderhit();
+	_mcts.ponderhit();
+}
+
+void Engine::clearRequests() {
+	_search.clearRequests();
+	_mateSolver.clearRequests();
+	_mcts.clearRequests();
 }
 
 Move Engine::randomMove(const std::vector<Move>& legalMoves, const Board& board) {
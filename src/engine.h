@@ -2,6 +2,11 @@
 #define ENGINE_H
 
 #include "board.h"
+#include "search.h"
+#include "mcts.h"
+#include "mate.h"
+#include "book.h"
+#include "bitbase.h"
 #include <string>
 #include <random>
 #include <functional>
@@ -14,14 +19,25 @@
 // Function type for move selection strategy
 using MoveSelectionFunc = std::function<Move(const std::vector<Move>&, const Board&)>;
 
+// Search depth used when no limits are given
+constexpr int DEFAULT_SEARCH_DEPTH = 6;
+
+// Ways the engine can select its moves
+enum class EngineStrategy {
+    AlphaBeta,          // Iterative deepening alpha-beta search
+    MonteCarlo,         // Monte Carlo tree search
+    SelectionFunction   // Custom move selection function
+};
+
 // Engine class that handles move selection and UCI protocol
 class Engine {
 public:
     // Constructor
     Engine();
     
-    // Set the current board position
-    void setPosition(const Board& board);
+    // Set the current board position, with the hash keys of the game's earlier
+    // positions for repetition detection
+    void setPosition(const Board& board, const std::vector<HashKey>& history = {});
     
     // Get the current board position
     const Board& getPosition() const;
@@ -29,9 +45,70 @@ public:
     // Select and make a move using the current strategy
     Move makeMove();
     
+    // Select and make a move, limiting the search if one is in use
+    Move makeMove(const SearchLimits& limits);
+    
     // Set a custom move selection strategy
     void setMoveSelectionStrategy(MoveSelectionFunc strategy);
     
+    // Select moves with the alpha-beta search instead of a selection strategy
+    void useSearch();
+    
+    // Check if moves are selected with the alpha-beta search
+    bool isUsingSearch() const { return _strategy == EngineStrategy::AlphaBeta; }
+    
+    // Choose how moves are selected (SelectionFunction uses the last strategy set)
+    void setStrategy(EngineStrategy strategy) { _strategy = strategy; }
+    
+    // Get how moves are selected
+    EngineStrategy strategy() const { return _strategy; }
+    
+    // Set the function that receives progress from both searches
+    void setInfoCallback(SearchInfoCallback callback);
+    
+    // Set the time reserved for communication delays per move
+    void setMoveOverhead(int64_t overheadMs);
+    
+    // Ask a running search to stop as soon as possible (thread-safe)
+    void stop();
+    
+    // Turn a pondering search into a normal timed search (thread-safe)
+    void ponderhit();
+    
+    // Clear previous stop and ponderhit requests before starting a new search
+    void clearRequests();
+    
+    // Check if a stop has been requested
+    bool stopRequested() const { return _search.stopRequested(); }
+    
+    // Check if a ponderhit has been received
+    bool ponderhitReceived() const { return _search.ponderhitReceived(); }
+    
+    // Expected reply to the last move made (invalid if unknown)
+    Move ponderMove() const { return _ponderMove; }
+    
+    // Access the alpha-beta search
+    Search& search() { return _search; }
+    
+    // Access the Monte Carlo tree search
+    MCTS& mcts() { return _mcts; }
+    
+    // Access the mate solver used for mate searches
+    MateSolver& mateSolver() { return _mateSolver; }
+    
+    // Access the opening book
+    Book& book() { return _book; }
+    
+    // Play moves from the opening book, when one is open, before using the strategy
+    void setOwnBook(bool enabled) { _ownBook = enabled; }
+    bool ownBook() const { return _ownBook; }
+
+#ifdef ENABLE_RL
+    // Evaluate tree search leaves in batches of up to batchSize positions, waiting at
+    // most maxLatencyUs for a batch to fill (a batch size of 1 evaluates directly)
+    void setEvalBatching(size_t batchSize, int64_t maxLatencyUs);
+#endif
+    
     // Default move selection strategies
     static Move randomMove(const std::vector<Move>& legalMoves, const Board& board);
 
@@ -47,9 +124,35 @@ private:
     // Current board position
     Board _board;
     
+    // Hash keys of the positions before the current one
+    std::vector<HashKey> _gameHistory;
+    
     // Current move selection strategy
     MoveSelectionFunc _moveSelectionStrategy;
     
+    // Searches and which way of selecting moves is in use
+    Search _search;
+    MCTS _mcts;
+    EngineStrategy _strategy;
+    
+    // Proof-number search answering mate searches before the strategy is used
+    MateSolver _mateSolver;
+    
+    // Progress callback, also given to the searches
+    SearchInfoCallback _infoCallback;
+    
+    // Expected reply to the last move made
+    Move _ponderMove;
+    
+    // Opening book and whether its moves are played
+    Book _book;
+    bool _ownBook;
+
+#ifdef ENABLE_RL
+    // Value network evaluating the tree search leaves (nullptr without a trained model)
+    std::shared_ptr<NeuralNetwork> _valueNetwork;
+#endif
+    
     // Random number generator for random move selection
     std::mt19937 _rng;
 
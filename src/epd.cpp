@@ -0,0 +1,202 @@
+#include "epd.h"
+#include <algorithm>
+#include <sstream>
+#include <cctype>
+
+namespace {
+    bool isNumber(const std::string& token) {
+        if (token.empty()) {
+            return false;
+        }
+        for (char c : token) {
+            if (!std::isdigit(static_cast<unsigned char>(c))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    PieceType sanPiece(char c) {
+        switch (c) {
+            case 'N': return KNIGHT;
+            case 'B': return BISHOP;
+            case 'R': return ROOK;
+            case 'Q': return QUEEN;
+            case 'K': return KING;
+            default: return NO_PIECE_TYPE;
+        }
+    }
+
+    std::string trim(const std::string& text) {
+        size_t begin = text.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos) {
+            return "";
+        }
+        size_t end = text.find_last_not_of(" \t\r\n");
+        return text.substr(begin, end - begin + 1);
+    }
+}
+
+const std::string* EpdRecord::operation(const std::string& opcode) const {
+    for (const auto& op : operations) {
+        if (op.first == opcode) {
+            return &op.second;
+        }
+    }
+    return nullptr;
+}
+
+bool parseEpd(const std::string& line, EpdRecord& record) {
+    record = EpdRecord();
+
+    std::string text = trim(line);
+    if (text.empty() || text[0] == '#') {
+        return false;
+    }
+
+    // Piece placement, side to move, castling and en passant fields
+    std::istringstream is(text);
+    std::string fields[4];
+    for (std::string& field : fields) {
+        if (!(is >> field)) {
+            return false;
+        }
+    }
+    if (fields[0].find('/') == std::string::npos) {
+        return false;
+    }
+
+    // A FEN continues with the halfmove clock and move number
+    std::string halfmove = "0";
+    std::string fullmove = "1";
+    std::streampos operationsStart = is.tellg();
+    std::string token;
+    if (is >> token && isNumber(token)) {
+        halfmove = token;
+        operationsStart = is.tellg();
+        if (is >> token && isNumber(token)) {
+            fullmove = token;
+            operationsStart = is.tellg();
+        }
+    }
+    record.fen = fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3] + " " + halfmove + " " + fullmove;
+
+    // Operations: "opcode operand...;" with operands optionally quoted
+    std::string rest = operationsStart == std::streampos(-1) ? "" : text.substr(static_cast<size_t>(operationsStart));
+    std::string current;
+    bool quoted = false;
+    for (char c : rest + ";") {
+        if (c == '"') {
+            quoted = !quoted;
+            continue;
+        }
+        if (c != ';' || quoted) {
+            current += c;
+            continue;
+        }
+
+        std::string op = trim(current);
+        current.clear();
+        if (op.empty()) {
+            continue;
+        }
+        size_t space = op.find_first_of(" \t");
+        if (space == std::string::npos) {
+            record.operations.emplace_back(op, "");
+        } else {
+            record.operations.emplace_back(op.substr(0, space), trim(op.substr(space)));
+        }
+    }
+    return true;
+}
+
+Move parseEpdMove(const Board& board, const std::string& text) {
+    // Check and annotation marks don't identify the move
+    std::string san;
+    for (char c : text) {
+        if (c != '+' && c != '#' && c != '!' && c != '?') {
+            san += c;
+        }
+    }
+
+    std::vector<Move> legalMoves = board.generateLegalMoves();
+    if (san.size() >= 4) {
+        Move move = Move::fromUci(san);
+        if (std::find(legalMoves.begin(), legalMoves.end(), move) != legalMoves.end()) {
+            return move;
+        }
+    }
+
+    // Castling is a king move to the g or c file
+    Color us = board.sideToMove();
+    Square kingFrom = BitboardUtils::squareFromRankFile(us == WHITE ? RANK_1 : RANK_8, FILE_E);
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+        File file = san.size() == 3 ? FILE_G : FILE_C;
+        Move castling(kingFrom, BitboardUtils::squareFromRankFile(us == WHITE ? RANK_1 : RANK_8, file));
+        return std::find(legalMoves.begin(), legalMoves.end(), castling) != legalMoves.end() ? castling : Move();
+    }
+
+    // Piece, then the disambiguation and capture marks, destination and promotion
+    PieceType piece = PAWN;
+    size_t begin = 0;
+    if (!san.empty() && sanPiece(san[0]) != NO_PIECE_TYPE) {
+        piece = sanPiece(san[0]);
+        begin = 1;
+    }
+    PieceType promotion = NO_PIECE_TYPE;
+    size_t end = san.size();
+    if (piece == PAWN && end > 0 && sanPiece(san[end - 1]) != NO_PIECE_TYPE) {
+        promotion = sanPiece(san[end - 1]);
+        end -= (end >= 2 && san[end - 2] == '=') ? 2 : 1;
+    }
+    if (end < begin + 2) {
+        return Move();
+    }
+    char toFile = san[end - 2];
+    char toRank = san[end - 1];
+    if (toFile < 'a' || toFile > 'h' || toRank < '1' || toRank > '8') {
+        return Move();
+    }
+    Square to = BitboardUtils::squareFromRankFile(static_cast<Rank>(toRank - '1'), static_cast<File>(toFile - 'a'));
+    std::string from = san.substr(begin, end - 2 - begin);
+    from.erase(std::remove(from.begin(), from.end(), 'x'), from.end());
+
+    Move found;
+    for (const Move& move : legalMoves) {
+        Color color;
+        if (move.to != to || move.promotion != promotion || board.pieceAt(move.from, color) != piece) {
+            continue;
+        }
+        bool matches = true;
+        for (char c : from) {
+            if (c >= 'a' && c <= 'h') {
+                matches = matches && BitboardUtils::squareFile(move.from) == c - 'a';
+            } else if (c >= '1' && c <= '8') {
+                matches = matches && BitboardUtils::squareRank(move.from) == c - '1';
+            } else {
+                matches = false;
+            }
+        }
+        if (matches) {
+            if (found.isValid()) {
+                return Move(); // Ambiguous
+            }
+            found = move;
+        }
+    }
+    return found;
+}
+
+bool parseEpdMoves(const Board& board, const std::string& operand, std::vector<Move>& moves) {
+    moves.clear();
+    std::istringstream is(operand);
+    std::string text;
+    while (is >> text) {
+        Move move = parseEpdMove(board, text);
+        if (!move.isValid()) {
+            return false;
+        }
+        moves.push_back(move);
+    }
+    return !moves.empty();
+}
@@ -0,0 +1,32 @@
+#ifndef EPD_H
+#define EPD_H
+
+#include "board.h"
+#include <string>
+#include <vector>
+#include <utility>
+
+// A position record from an EPD or FEN file
+struct EpdRecord {
+    // Full FEN of the position (EPD records get a zero halfmove clock and move number one)
+    std::string fen;
+
+    // Operations in file order, as opcode and operand text (quotes removed)
+    std::vector<std::pair<std::string, std::string>> operations;
+
+    // Get the operand of an operation, nullptr if the record doesn't have it
+    const std::string* operation(const std::string& opcode) const;
+};
+
+// Parse a line holding a FEN or an EPD record (false for blank lines, comments and
+// lines that don't start with a position)
+bool parseEpd(const std::string& line, EpdRecord& record);
+
+// Find the legal move written in SAN ("Nxe5+", "exd8=Q", "O-O") or UCI ("g1f3") notation,
+// an invalid move if there is none or the notation is ambiguous
+Move parseEpdMove(const Board& board, const std::string& text);
+
+// Moves of an operand listing one or more moves (as for bm and am); false if any isn't legal
+bool parseEpdMoves(const Board& board, const std::string& operand, std::vector<Move>& moves);
+
+#endif // EPD_H
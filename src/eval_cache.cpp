@@ -0,0 +1,72 @@
+#include "eval_cache.h"
+#include <cstring>
+
+namespace {
+    // Pack a model version and a value into one word
+    uint64_t packEntry(uint32_t version, float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (static_cast<uint64_t>(version) << 32) | bits;
+    }
+
+    float unpackValue(uint64_t data) {
+        uint32_t bits = static_cast<uint32_t>(data);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+}
+
+EvalCache::EvalCache(size_t entries) : hitCount(0), probeCount(0) {
+    // Largest power of two not above the requested size
+    size_t count = 1;
+    while (count * 2 <= entries) {
+        count *= 2;
+    }
+    mask = count - 1;
+    this->entries = std::make_unique<Entry[]>(count);
+    clear();
+}
+
+bool EvalCache::probe(uint64_t key, uint32_t version, float& value) const {
+    probeCount.fetch_add(1, std::memory_order_relaxed);
+
+    const Entry& entry = entries[key & mask];
+    uint64_t data = entry.data.load(std::memory_order_relaxed);
+    uint64_t check = entry.check.load(std::memory_order_relaxed);
+
+    // The check word only matches if both words come from the same store
+    if ((check ^ data) != key || static_cast<uint32_t>(data >> 32) != version) {
+        return false;
+    }
+
+    value = unpackValue(data);
+    hitCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void EvalCache::store(uint64_t key, uint32_t version, float value) {
+    Entry& entry = entries[key & mask];
+    uint64_t data = packEntry(version, value);
+    entry.data.store(data, std::memory_order_relaxed);
+    entry.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void EvalCache::clear() {
+    // An all-zero entry would verify for key 0 and version 0, so make it fail verification
+    for (size_t i = 0; i <= mask; i++) {
+        entries[i].data.store(0, std::memory_order_relaxed);
+        entries[i].check.store(~uint64_t(0), std::memory_order_relaxed);
+    }
+    resetStats();
+}
+
+double EvalCache::hitRate() const {
+    uint64_t total = probes();
+    return total > 0 ? static_cast<double>(hits()) / total : 0.0;
+}
+
+void EvalCache::resetStats() {
+    hitCount.store(0, std::memory_order_relaxed);
+    probeCount.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// Default number of cached evaluations (rounded down to a power of two)
+constexpr size_t DEFAULT_EVAL_CACHE_ENTRIES = size_t(1) << 16;
+
+// Fixed-size cache of network evaluations keyed by position hash and model version.
+// Lock-free: each entry stores its key XORed with its data, so an entry torn by
+// concurrent writers fails verification and reads as a miss.
+class EvalCache {
+public:
+    explicit EvalCache(size_t entries = DEFAULT_EVAL_CACHE_ENTRIES);
+
+    // Look up the value stored for a position by the given model version
+    bool probe(uint64_t key, uint32_t version, float& value) const;
+
+    // Store a value, replacing whatever occupied the slot
+    void store(uint64_t key, uint32_t version, float value);
+
+    // Remove all entries and reset the statistics
+    void clear();
+
+    // Lookup statistics
+    uint64_t hits() const { return hitCount.load(std::memory_order_relaxed); }
+    uint64_t probes() const { return probeCount.load(std::memory_order_relaxed); }
+    double hitRate() const;
+    void resetStats();
+
+    size_t size() const { return mask + 1; }
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    std::unique_ptr<Entry[]> entries;
+    size_t mask;
+
+    mutable std::atomic<uint64_t> hitCount;
+    mutable std::atomic<uint64_t> probeCount;
+};
@@ -0,0 +1,46 @@
+#ifndef EVALUATE_H
+#define EVALUATE_H
+
+#include "bitboard.h"
+#include <array>
+
+class Board;
+
+// Handcrafted evaluation, tapered between middlegame and endgame weights
+namespace Eval {
+    // A pair of middlegame and endgame values
+    struct Score {
+        int mg = 0;
+        int eg = 0;
+
+        constexpr Score() = default;
+        constexpr Score(int mg, int eg) : mg(mg), eg(eg) {}
+
+        constexpr Score operator+(const Score& other) const { return Score(mg + other.mg, eg + other.eg); }
+        constexpr Score operator-(const Score& other) const { return Score(mg - other.mg, eg - other.eg); }
+        constexpr Score operator*(int factor) const { return Score(mg * factor, eg * factor); }
+        Score& operator+=(const Score& other) { mg += other.mg; eg += other.eg; return *this; }
+        Score& operator-=(const Score& other) { mg -= other.mg; eg -= other.eg; return *this; }
+        constexpr bool operator==(const Score& other) const { return mg == other.mg && eg == other.eg; }
+    };
+
+    // Game phase contributed by each piece type, a full set of pieces adds up to PHASE_MAX
+    extern const std::array<int, 6> PHASE_WEIGHTS;
+    constexpr int PHASE_MAX = 24;
+
+    // Material plus piece-square value of each piece on each square, indexed by [color][piece_type][square].
+    // Black values are negated so a position's score is the plain sum over all pieces.
+    extern const std::array<std::array<std::array<Score, 64>, 6>, 2> PSQT;
+
+    // Compute the material and piece-square score (White's point of view) and the
+    // game phase of a position from scratch
+    void computePsqt(const Board& board, Score& psqt, int& phase);
+
+    // Evaluate a position from the side to move's point of view, in centipawns
+    int evaluate(const Board& board);
+
+    // Blend a score by game phase (PHASE_MAX is pure middlegame, 0 pure endgame)
+    int taper(const Score& score, int phase);
+}
+
+#endif // EVALUATE_H
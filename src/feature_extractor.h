@@ -6,9 +6,24 @@
 // Feature extraction from chess board
 class BoardFeatureExtractor {
 public:
+    // One-hot piece features (12 per square) followed by the game state features
+    static constexpr size_t NUM_PIECE_FEATURES = 64 * 12;
+    static constexpr size_t NUM_STATE_FEATURES = 9;
+
     // Convert a board position to input features for the neural network
     static std::vector<float> extractFeatures(const Board& board);
     
+    // Write the input features of a board to out (getFeatureSize() values)
+    static void extractFeatures(const Board& board, float* out);
+    
     // Get the size of the feature vector for a given board
     static size_t getFeatureSize();
-};
\ No newline at end of file
+    
+    // Index of the one-hot feature for a piece on a square
+    static size_t pieceFeatureIndex(Square sq, PieceType piece, Color color) {
+        return sq * 12 + piece * 2 + color;
+    }
+    
+    // Write the game state features (side to move, castling, en passant, clock, checks) to out
+    static void extractStateFeatures(const Board& board, float* out);
+};
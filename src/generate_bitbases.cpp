@@ -0,0 +1,58 @@
+#include "bitboard.h"
+#include "bitbase.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Generate the endgame bitbases into a directory (bitbases by default), skipping those
+// already there. Each ending only needs the ones before it.
+int main(int argc, char* argv[]) {
+    BitboardUtils::initBitboards();
+
+    std::string directory = argc > 1 ? argv[1] : DEFAULT_BITBASE_DIRECTORY;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    Bitbases::load(directory);
+
+    for (const Bitbases::Ending& ending : Bitbases::endings()) {
+        std::string filename = Bitbases::tableFile(directory, ending);
+
+        // Reuse a table that loaded from the directory
+        if (Bitbases::available(ending)) {
+            std::cout << ending.name << ": found " << filename << std::endl;
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<uint8_t> table;
+        if (!Bitbases::generate(ending, table, threads)) {
+            std::cerr << ending.name << ": tables it converts into are missing" << std::endl;
+            return 1;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        // Tally the results for the side to move
+        size_t counts[4] = {};
+        for (size_t index = 0; index < Bitbases::tableSize(ending); ++index) {
+            counts[(table[index >> 2] >> ((index & 3) * 2)) & 3]++;
+        }
+
+        if (!Bitbases::save(filename, table)) {
+            std::cerr << ending.name << ": could not write " << filename << std::endl;
+            return 1;
+        }
+        Bitbases::add(ending, std::move(table));
+
+        std::cout << ending.name << ": " << counts[3] << " wins, " << counts[2] << " draws, "
+                  << counts[1] << " losses, " << counts[0] << " invalid (" << elapsed << " ms)" << std::endl;
+    }
+
+    return 0;
+}
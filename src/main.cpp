@@ -1,11 +1,21 @@
+#include "bitbase.h"
 #include "bitboard.h"
 #include "uci.h"
+#include "cli.h"
 #include <iostream>
 
-int main() {
+int main(int argc, char* argv[]) {
     // Initialize bitboards
     BitboardUtils::initBitboards();
     
+    // Arguments select a command-line mode instead of the UCI loop
+    if (argc > 1) {
+        return Cli::run(argc, argv);
+    }
+    
+    // Endgame bitbases are shared by every search, loaded before any starts
+    Bitbases::load(DEFAULT_BITBASE_DIRECTORY);
+    
     // Create UCI interface
     UCI uci;
     
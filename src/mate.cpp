@@ -0,0 +1,234 @@
+#include "mate.h"
+#include <algorithm>
+
+namespace {
+    // Number of nodes between clock checks (power of two)
+    const uint64_t TIME_CHECK_INTERVAL = 1024;
+
+    // Spreads the entries of one position searched with different numbers of moves left
+    const HashKey MOVES_LEFT_KEY = 0x9E3779B97F4A7C15ULL;
+}
+
+MateSolver::MateSolver(size_t hashMb) : _mask(0), _stopRequested(false), _stop(false), _nodes(0) {
+    setHashSize(hashMb);
+}
+
+void MateSolver::setHashSize(size_t sizeMb) {
+    if (sizeMb == 0) {
+        sizeMb = 1;
+    }
+
+    // Round the number of entries down to a power of two
+    size_t maxEntries = sizeMb * 1024 * 1024 / sizeof(Entry);
+    size_t numEntries = 1;
+    while (numEntries * 2 <= maxEntries) {
+        numEntries *= 2;
+    }
+
+    _table.assign(numEntries, Entry{});
+    _mask = numEntries - 1;
+}
+
+void MateSolver::clear() {
+    std::fill(_table.begin(), _table.end(), Entry{});
+}
+
+MateResult MateSolver::solve(const Board& board, int maxMoves, const SearchLimits& limits) {
+    MateResult result;
+
+    _nodes = 0;
+    _stop = false;
+    _limits = limits;
+    _timeManager.start(limits, board.sideToMove());
+
+    // Proofs from earlier searches remain valid, the table only needs clearing for a new game
+    for (int moves = 1; moves <= maxMoves && !_stop; ++moves) {
+        search(board, moves, true, INFINITE, INFINITE);
+        if (_stop) {
+            break;
+        }
+
+        uint32_t phi, delta;
+        lookup(board.hash(), moves, phi, delta);
+        if (phi == 0) {
+            result.found = true;
+            result.moves = moves;
+            result.pv = extractPv(board, moves);
+            break;
+        }
+    }
+
+    result.disproven = !result.found && !_stop;
+    result.nodes = _nodes;
+    result.timeMs = _timeManager.elapsed();
+    return result;
+}
+
+void MateSolver::search(const Board& board, int movesLeft, bool attacker, uint32_t thPhi, uint32_t thDelta) {
+    _nodes++;
+    checkLimits();
+    if (_stop) {
+        return;
+    }
+
+    const HashKey key = board.hash();
+
+    // Leaves: the attacker has no move that can still mate, the defender is mated or
+    // stalemated, or the defender survives the attacker's last move
+    std::vector<Move> moves = candidateMoves(board, movesLeft, attacker);
+    if (moves.empty() || (!attacker && movesLeft == 0)) {
+        bool reachesGoal = !attacker && (!moves.empty() || !board.isInCheck(board.sideToMove()));
+        store(key, movesLeft, reachesGoal ? 0 : INFINITE, reachesGoal ? INFINITE : 0, Move());
+        return;
+    }
+
+    // Children and the number of moves the attacker has left in them
+    const int childMovesLeft = attacker ? movesLeft - 1 : movesLeft;
+    std::vector<Board> children;
+    children.reserve(moves.size());
+    for (const Move& move : moves) {
+        children.push_back(board);
+        children.back().makeMove(move);
+    }
+
+    while (true) {
+        // phi is the smallest delta of a child, delta the sum of the children's phi
+        uint64_t phiSum = 0;
+        uint32_t bestDelta = INFINITE;
+        uint32_t secondDelta = INFINITE;
+        uint32_t bestPhi = 0;
+        size_t best = 0;
+        for (size_t i = 0; i < children.size(); ++i) {
+            uint32_t childPhi, childDelta;
+            lookup(children[i].hash(), childMovesLeft, childPhi, childDelta);
+            phiSum += childPhi;
+
+            if (childDelta < bestDelta) {
+                secondDelta = bestDelta;
+                bestDelta = childDelta;
+                bestPhi = childPhi;
+                best = i;
+            } else if (childDelta < secondDelta) {
+                secondDelta = childDelta;
+            }
+        }
+        uint32_t phi = bestDelta;
+        uint32_t delta = static_cast<uint32_t>(std::min<uint64_t>(phiSum, INFINITE));
+
+        store(key, movesLeft, phi, delta, moves[best]);
+        if (phi >= thPhi || delta >= thDelta || _stop) {
+            return;
+        }
+
+        // Search the most proving child until it is no longer the best or the node's
+        // numbers would pass a threshold
+        uint64_t childThPhi = static_cast<uint64_t>(thDelta) + bestPhi - delta;
+        uint32_t childThDelta = std::min<uint64_t>(thPhi, static_cast<uint64_t>(secondDelta) + 1);
+        search(children[best], childMovesLeft, !attacker,
+               static_cast<uint32_t>(std::min<uint64_t>(childThPhi, INFINITE)), childThDelta);
+    }
+}
+
+std::vector<Move> MateSolver::candidateMoves(const Board& board, int movesLeft, bool attacker) {
+    std::vector<Move> moves = board.generateLegalMoves();
+    if (!attacker || movesLeft != 1) {
+        return moves;
+    }
+
+    std::vector<Move> checks;
+    for (const Move& move : moves) {
+        Board child = board;
+        child.makeMove(move);
+        if (child.isInCheck(child.sideToMove())) {
+            checks.push_back(move);
+        }
+    }
+    return checks;
+}
+
+const MateSolver::Entry* MateSolver::probe(HashKey key, int movesLeft) const {
+    const Entry& entry = _table[(key ^ (movesLeft * MOVES_LEFT_KEY)) & _mask];
+    if (entry.key == key && entry.movesLeft == movesLeft && (entry.phi != 0 || entry.delta != 0)) {
+        return &entry;
+    }
+    return nullptr;
+}
+
+void MateSolver::lookup(HashKey key, int movesLeft, uint32_t& phi, uint32_t& delta) const {
+    const Entry* entry = probe(key, movesLeft);
+    phi = entry ? entry->phi : UNKNOWN;
+    delta = entry ? entry->delta : UNKNOWN;
+}
+
+void MateSolver::store(HashKey key, int movesLeft, uint32_t phi, uint32_t delta, Move move) {
+    Entry& entry = _table[(key ^ (movesLeft * MOVES_LEFT_KEY)) & _mask];
+    entry.key = key;
+    entry.phi = phi;
+    entry.delta = delta;
+    entry.move = move.pack();
+    entry.movesLeft = static_cast<int8_t>(movesLeft);
+}
+
+std::vector<Move> MateSolver::extractPv(const Board& board, int movesLeft) const {
+    std::vector<Move> pv;
+    Board position = board;
+    bool attacker = true;
+
+    while (true) {
+        std::vector<Move> moves = candidateMoves(position, movesLeft, attacker);
+        if (moves.empty() || (!attacker && movesLeft == 0)) {
+            break;
+        }
+
+        // The attacker plays a proven move. The defender resists longest: it prefers
+        // replies after which the attacker needs all the remaining moves.
+        const int childMovesLeft = attacker ? movesLeft - 1 : movesLeft;
+        Move chosen;
+        for (const Move& move : moves) {
+            Board child = position;
+            child.makeMove(move);
+            const Entry* entry = probe(child.hash(), childMovesLeft);
+            bool proven = entry && (attacker ? entry->delta == 0 : entry->phi == 0);
+            if (!proven) {
+                continue;
+            }
+            if (attacker) {
+                chosen = move;
+                break;
+            }
+            const Entry* shorter = probe(child.hash(), childMovesLeft - 1);
+            bool longest = !shorter || shorter->phi != 0;
+            if (!chosen.isValid() || longest) {
+                chosen = move;
+                if (longest) {
+                    break;
+                }
+            }
+        }
+        if (!chosen.isValid()) {
+            break;
+        }
+
+        pv.push_back(chosen);
+        position.makeMove(chosen);
+        movesLeft = childMovesLeft;
+        attacker = !attacker;
+    }
+    return pv;
+}
+
+void MateSolver::checkLimits() {
+    if (_stopRequested.load(std::memory_order_relaxed)) {
+        _stop = true;
+        return;
+    }
+
+    if (_limits.nodes > 0 && _nodes >= _limits.nodes) {
+        _stop = true;
+    }
+
+    // Reading the clock is comparatively slow, so only do it every few nodes
+    if ((_nodes & (TIME_CHECK_INTERVAL - 1)) == 0 && _timeManager.hardLimitReached()) {
+        _stop = true;
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef MATE_H
+#define MATE_H
+
+#include "board.h"
+#include "search.h"
+#include "timeman.h"
+#include <vector>
+#include <atomic>
+#include <cstdint>
+
+// Hash size of the mate solver in megabytes
+constexpr size_t DEFAULT_MATE_HASH_MB = 16;
+
+// Outcome of a mate search
+struct MateResult {
+    // A forced mate was proven
+    bool found = false;
+
+    // The position was searched completely without finding a mate in the allowed moves
+    bool disproven = false;
+
+    // Length of the shortest mate in moves, and a mating line
+    int moves = 0;
+    std::vector<Move> pv;
+
+    uint64_t nodes = 0;
+    int64_t timeMs = 0;
+};
+
+// Depth-first proof-number (df-pn) search for forced mates. The attacker is the side to
+// move at the root; each node keeps proof and disproof numbers in a hash table, and the
+// search always expands the most proving node below the current thresholds. Mates of
+// increasing length are tried in turn, so the first one proven is the shortest.
+class MateSolver {
+public:
+    // Constructor
+    explicit MateSolver(size_t hashMb = DEFAULT_MATE_HASH_MB);
+
+    // Look for a mate in at most maxMoves moves, within the node and time limits
+    MateResult solve(const Board& board, int maxMoves, const SearchLimits& limits = SearchLimits());
+
+    // Resize the hash table (clears it)
+    void setHashSize(size_t sizeMb);
+
+    // Forget all proofs
+    void clear();
+
+    // Ask a running search to stop as soon as possible (thread-safe)
+    void stop() { _stopRequested = true; }
+
+    // Clear a previous stop request before starting a new search
+    void clearRequests() { _stopRequested = false; }
+
+    // Access the time manager
+    TimeManager& timeManager() { return _timeManager; }
+
+private:
+    // Proof and disproof numbers of a node seen from its side to move: phi is the
+    // number to prove the side to move wins the goal, delta to prove it loses it
+    struct Entry {
+        HashKey key;
+        uint32_t phi;
+        uint32_t delta;
+        uint16_t move;
+        int8_t movesLeft;
+    };
+
+    // Numbers of an unsolved node that hasn't been searched yet
+    static constexpr uint32_t UNKNOWN = 1;
+
+    // Numbers of a solved node
+    static constexpr uint32_t INFINITE = 100000000;
+
+    // Expand a node until its numbers reach one of the thresholds
+    void search(const Board& board, int movesLeft, bool attacker, uint32_t thPhi, uint32_t thDelta);
+
+    // Look up the numbers of a node (unknown if not stored)
+    void lookup(HashKey key, int movesLeft, uint32_t& phi, uint32_t& delta) const;
+
+    // Store the numbers of a node
+    void store(HashKey key, int movesLeft, uint32_t phi, uint32_t delta, Move move);
+
+    // Find a node's entry, nullptr if not stored
+    const Entry* probe(HashKey key, int movesLeft) const;
+
+    // Follow the proof through the table to build the mating line
+    std::vector<Move> extractPv(const Board& board, int movesLeft) const;
+
+    // Stop the search if the time or node limit has been reached
+    void checkLimits();
+
+    // Moves worth trying at a node: with a single move left only checks can mate
+    static std::vector<Move> candidateMoves(const Board& board, int movesLeft, bool attacker);
+
+    // Hash table of node numbers
+    std::vector<Entry> _table;
+    size_t _mask;
+
+    // Limits of the current search
+    SearchLimits _limits;
+    TimeManager _timeManager;
+
+    // Set by another thread to interrupt the search
+    std::atomic<bool> _stopRequested;
+
+    // Set when the search must unwind
+    bool _stop;
+
+    uint64_t _nodes;
+};
+
+#endif // MATE_H
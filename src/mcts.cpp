@@ -0,0 +1,419 @@
+#include "mcts.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace {
+    // Constants of the value <-> centipawn conversion (same curve as Leela Chess Zero)
+    const float CP_SCALE = 111.714640912f;
+    const float CP_SLOPE = 1.5620688421f;
+
+    // Move a node out of its parent's child array into a node of its own
+    std::unique_ptr<MCTSNode> detach(MCTSNode& node) {
+        auto detached = std::make_unique<MCTSNode>();
+        detached->move = node.move;
+        detached->prior = node.prior;
+        detached->visits.store(node.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        detached->valueSum.store(node.valueSum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        detached->state.store(node.state.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        detached->terminal = node.terminal;
+        detached->terminalValue = node.terminalValue;
+        detached->children = std::move(node.children);
+        detached->numChildren = node.numChildren;
+        return detached;
+    }
+
+    // Add to an atomic float (fetch_add on floats needs C++20)
+    void atomicAdd(std::atomic<float>& target, float value) {
+        float current = target.load(std::memory_order_relaxed);
+        while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+float MCTSNode::q() const {
+    uint32_t n = visits.load(std::memory_order_relaxed);
+    return n > 0 ? valueSum.load(std::memory_order_relaxed) / n : 0.0f;
+}
+
+MCTS::MCTS() : _evaluator(&MCTS::staticEvaluator), _visitBudget(0), _stopRequested(false), _ponderhitRequested(false),
+               _pondering(false), _stop(false), _simulations(0), _treeNodes(0), _depthSum(0), _selDepth(0) {
+}
+
+void MCTS::setHashSize(size_t sizeMb) {
+    _options.maxNodes = std::max<uint64_t>(sizeMb * 1024 * 1024 / sizeof(MCTSNode), 1);
+}
+
+void MCTS::setEvaluator(LeafEvaluator evaluator) {
+    _evaluator = evaluator ? evaluator : LeafEvaluator(&MCTS::staticEvaluator);
+
+    // Values backed up with another evaluator don't mix with new ones
+    clear();
+}
+
+void MCTS::clear() {
+    _root.reset();
+    _treeNodes = 0;
+}
+
+void MCTS::setInfoCallback(SearchInfoCallback callback) {
+    _infoCallback = callback;
+}
+
+float MCTS::staticEvaluator(const Board& board) {
+    return std::atan(Search::evaluate(board) / CP_SCALE) / CP_SLOPE;
+}
+
+int MCTS::valueToCentipawns(float value) {
+    value = std::clamp(value, -0.999f, 0.999f);
+    int cp = static_cast<int>(std::lround(CP_SCALE * std::tan(CP_SLOPE * value)));
+    return std::clamp(cp, -VALUE_MATE_IN_MAX_PLY + 1, VALUE_MATE_IN_MAX_PLY - 1);
+}
+
+SearchResult MCTS::run(const Board& board, const SearchLimits& limits) {
+    SearchResult result;
+
+    std::vector<Move> rootMoves = board.generateLegalMoves();
+    if (rootMoves.empty()) {
+        return result;
+    }
+    result.bestMove = rootMoves[0];
+
+    // Continue from what the last search learned about this position, typically
+    // two plies down after our move and the opponent's reply
+    _root = _options.reuseTree ? reuseTree(board) : nullptr;
+    if (!_root) {
+        _root = std::make_unique<MCTSNode>();
+    }
+    _treeNodes = countNodes(*_root);
+    _rootBoard = board;
+    _limits = limits;
+    _stop = false;
+    _simulations = 0;
+    _depthSum = 0;
+    _selDepth = 0;
+    _startTime = std::chrono::steady_clock::now();
+
+    // While pondering the clock isn't ours, so time limits start at ponderhit
+    Color us = board.sideToMove();
+    _pondering = limits.ponder && !_ponderhitRequested;
+    SearchLimits timeLimits = limits;
+    timeLimits.infinite = limits.infinite || _pondering;
+    _timeManager.start(timeLimits, us);
+
+    // A node limit caps the visits, otherwise the clock decides or the default budget applies
+    bool clockLimited = limits.time[us] > 0 || limits.moveTime > 0;
+    if (limits.nodes > 0) {
+        _visitBudget = limits.nodes;
+    } else if (clockLimited || limits.infinite) {
+        _visitBudget = std::numeric_limits<uint64_t>::max();
+    } else {
+        _visitBudget = _options.visits;
+    }
+
+    std::vector<std::thread> workers;
+    int threads = std::max(1, _options.threads);
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(&MCTS::worker, this);
+    }
+
+    // Watch the limits while the workers search
+    int64_t lastInfo = 0;
+    while (!_stop) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        if (_stopRequested.load(std::memory_order_relaxed)) {
+            _stop = true;
+            break;
+        }
+
+        // The opponent played the expected move: the clock is now ours
+        if (_pondering && _ponderhitRequested.load(std::memory_order_relaxed)) {
+            SearchLimits ourLimits = _limits;
+            ourLimits.ponder = false;
+            _timeManager.start(ourLimits, us);
+            _pondering = false;
+        }
+
+        // A visit spends far less than an iteration, so search up to the soft limit
+        if (!_pondering && _timeManager.isTimed() && _simulations > 0 &&
+            _timeManager.elapsed() >= _timeManager.softLimit()) {
+            _stop = true;
+        }
+
+        if (elapsedMs() - lastInfo >= DEFAULT_INFO_INTERVAL_MS) {
+            lastInfo = elapsedMs();
+            sendInfo();
+        }
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    sendInfo();
+
+    // Play the most visited move and expect the most visited reply
+    const MCTSNode* best = bestChild(*_root);
+    if (best) {
+        result.bestMove = best->move;
+        const MCTSNode* reply = best->state.load(std::memory_order_acquire) == MCTSNode::EXPANDED
+            ? bestChild(*best) : nullptr;
+        if (reply) {
+            result.ponderMove = reply->move;
+        }
+        result.score = best->terminal && best->terminalValue > 0.0f
+            ? VALUE_MATE - 1 : valueToCentipawns(best->q());
+    }
+    uint64_t simulations = _simulations;
+    result.depth = simulations > 0 ? static_cast<int>(_depthSum / simulations) : 0;
+    result.nodes = simulations;
+
+    return result;
+}
+
+std::unique_ptr<MCTSNode> MCTS::reuseTree(const Board& board) {
+    if (!_root) {
+        return nullptr;
+    }
+    if (_rootBoard.hash() == board.hash()) {
+        return std::move(_root);
+    }
+    if (_root->state.load(std::memory_order_acquire) != MCTSNode::EXPANDED) {
+        return nullptr;
+    }
+
+    for (int i = 0; i < _root->numChildren; ++i) {
+        MCTSNode& child = _root->children[i];
+        Board childBoard = _rootBoard;
+        childBoard.makeMove(child.move);
+        if (childBoard.hash() == board.hash()) {
+            return detach(child);
+        }
+        if (child.state.load(std::memory_order_acquire) != MCTSNode::EXPANDED) {
+            continue;
+        }
+
+        for (int j = 0; j < child.numChildren; ++j) {
+            MCTSNode& grandchild = child.children[j];
+            Board grandchildBoard = childBoard;
+            grandchildBoard.makeMove(grandchild.move);
+            if (grandchildBoard.hash() == board.hash()) {
+                return detach(grandchild);
+            }
+        }
+    }
+    return nullptr;
+}
+
+void MCTS::worker() {
+    while (!_stop.load(std::memory_order_relaxed)) {
+        // An explicit node limit holds while pondering too, the default budgets start at ponderhit
+        if ((_limits.nodes > 0 || !_pondering) && _simulations.load(std::memory_order_relaxed) >= _visitBudget) {
+            _stop = true;
+            break;
+        }
+
+        // Another thread is expanding the leaf we reached, give it time to finish
+        if (!simulate()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool MCTS::simulate() {
+    MCTSNode* path[MAX_PLY + 1];
+    HashKey keys[MAX_PLY + 1];
+    int length = 0;
+
+    Board board = _rootBoard;
+    MCTSNode* node = _root.get();
+    path[length] = node;
+    keys[length] = board.hash();
+    length++;
+
+    // Descend through expanded nodes, marking the path with virtual losses
+    bool repetition = false;
+    while (node->state.load(std::memory_order_acquire) == MCTSNode::EXPANDED && !node->terminal &&
+           length <= MAX_PLY) {
+        node = selectChild(*node);
+        node->virtualLoss.fetch_add(_options.virtualLoss, std::memory_order_relaxed);
+        board.makeMove(node->move);
+        path[length] = node;
+        keys[length] = board.hash();
+        length++;
+
+        // A position repeated on the path is a draw along this line
+        for (int i = length - 3; i >= 0 && i >= length - 1 - board.halfmoveClock(); i -= 2) {
+            if (keys[i] == keys[length - 1]) {
+                repetition = true;
+                break;
+            }
+        }
+        if (repetition) {
+            break;
+        }
+    }
+
+    // Value of the leaf for the side that moved into it
+    float value;
+    if (repetition || length > MAX_PLY) {
+        value = 0.0f;
+    } else if (node->state.load(std::memory_order_acquire) == MCTSNode::EXPANDED && node->terminal) {
+        value = node->terminalValue;
+    } else {
+        uint8_t expected = MCTSNode::UNEXPANDED;
+        if (!node->state.compare_exchange_strong(expected, MCTSNode::EXPANDING, std::memory_order_acq_rel)) {
+            // Collision with another thread's expansion: undo the virtual losses and retry
+            for (int i = 1; i < length; ++i) {
+                path[i]->virtualLoss.fetch_sub(_options.virtualLoss, std::memory_order_relaxed);
+            }
+            return false;
+        }
+        value = -expand(*node, board);
+        bool expanded = node->numChildren > 0 || node->terminal;
+        node->state.store(expanded ? MCTSNode::EXPANDED : MCTSNode::UNEXPANDED, std::memory_order_release);
+    }
+
+    // Back up the value, flipping the point of view at every ply
+    for (int i = length - 1; i >= 0; --i) {
+        atomicAdd(path[i]->valueSum, value);
+        path[i]->visits.fetch_add(1, std::memory_order_relaxed);
+        if (i > 0) {
+            path[i]->virtualLoss.fetch_sub(_options.virtualLoss, std::memory_order_relaxed);
+        }
+        value = -value;
+    }
+
+    _simulations.fetch_add(1, std::memory_order_relaxed);
+    _depthSum.fetch_add(length - 1, std::memory_order_relaxed);
+    int selDepth = _selDepth.load(std::memory_order_relaxed);
+    while (length - 1 > selDepth && !_selDepth.compare_exchange_weak(selDepth, length - 1)) {
+    }
+
+    return true;
+}
+
+float MCTS::expand(MCTSNode& node, const Board& board) {
+    std::vector<Move> moves = board.generateLegalMoves();
+
+    // Game over: checkmate is a loss for the side to move, everything else a draw
+    if (moves.empty()) {
+        node.terminal = true;
+        node.terminalValue = board.isInCheck(board.sideToMove()) ? 1.0f : 0.0f;
+        return -node.terminalValue;
+    }
+    if (board.halfmoveClock() >= 100 || board.isInsufficientMaterial()) {
+        node.terminal = true;
+        node.terminalValue = 0.0f;
+        return 0.0f;
+    }
+
+    // Reserve the children's place in the tree, or stop growing it
+    if (_treeNodes.fetch_add(moves.size(), std::memory_order_relaxed) + moves.size() > _options.maxNodes) {
+        _treeNodes.fetch_sub(moves.size(), std::memory_order_relaxed);
+        _stop = true;
+        return std::clamp(_evaluator(board), -1.0f, 1.0f);
+    }
+
+    // The value network has no policy head, so all moves start with the same prior
+    node.children = std::make_unique<MCTSNode[]>(moves.size());
+    node.numChildren = static_cast<int>(moves.size());
+    float prior = 1.0f / moves.size();
+    for (size_t i = 0; i < moves.size(); ++i) {
+        node.children[i].move = moves[i];
+        node.children[i].prior = prior;
+    }
+
+    return std::clamp(_evaluator(board), -1.0f, 1.0f);
+}
+
+uint64_t MCTS::countNodes(const MCTSNode& node) {
+    uint64_t count = 1;
+    for (int i = 0; i < node.numChildren; ++i) {
+        count += countNodes(node.children[i]);
+    }
+    return count;
+}
+
+MCTSNode* MCTS::selectChild(MCTSNode& node) const {
+    uint32_t parentVisits = node.visits.load(std::memory_order_relaxed) +
+                            node.virtualLoss.load(std::memory_order_relaxed);
+    float explore = _options.cpuct * std::sqrt(static_cast<float>(std::max<uint32_t>(parentVisits, 1)));
+
+    // Unvisited children start at the parent's value, seen by the side to move
+    float firstPlayUrgency = -node.q();
+
+    MCTSNode* best = nullptr;
+    float bestScore = -std::numeric_limits<float>::infinity();
+    for (int i = 0; i < node.numChildren; ++i) {
+        MCTSNode& child = node.children[i];
+        uint32_t visits = child.visits.load(std::memory_order_relaxed);
+        uint32_t pending = child.virtualLoss.load(std::memory_order_relaxed);
+
+        // Pending visits count as losses so concurrent threads spread out
+        float q = visits + pending > 0
+            ? (child.valueSum.load(std::memory_order_relaxed) - pending) / (visits + pending)
+            : firstPlayUrgency;
+        float score = q + explore * child.prior / (1 + visits + pending);
+
+        if (score > bestScore) {
+            bestScore = score;
+            best = &child;
+        }
+    }
+    return best;
+}
+
+const MCTSNode* MCTS::bestChild(const MCTSNode& node) {
+    const MCTSNode* best = nullptr;
+    for (int i = 0; i < node.numChildren; ++i) {
+        const MCTSNode& child = node.children[i];
+        uint32_t visits = child.visits.load(std::memory_order_relaxed);
+        if (visits == 0) {
+            continue;
+        }
+        if (!best || visits > best->visits.load(std::memory_order_relaxed) ||
+            (visits == best->visits.load(std::memory_order_relaxed) && child.q() > best->q())) {
+            best = &child;
+        }
+    }
+    return best;
+}
+
+void MCTS::sendInfo() const {
+    if (!_infoCallback) {
+        return;
+    }
+
+    SearchInfo info;
+    info.nodes = _simulations;
+    info.depth = info.nodes > 0 ? static_cast<int>(_depthSum / info.nodes) : 0;
+    info.selDepth = _selDepth;
+    info.timeMs = elapsedMs();
+
+    // Follow the most visited moves through the tree
+    const MCTSNode* node = _root.get();
+    while (node->state.load(std::memory_order_acquire) == MCTSNode::EXPANDED) {
+        const MCTSNode* child = bestChild(*node);
+        if (!child) {
+            break;
+        }
+        info.pv.push_back(child->move);
+        node = child;
+    }
+
+    const MCTSNode* best = bestChild(*_root);
+    if (best) {
+        info.score = best->terminal && best->terminalValue > 0.0f
+            ? VALUE_MATE - 1 : valueToCentipawns(best->q());
+    }
+
+    _infoCallback(info);
+}
+
+int64_t MCTS::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - _startTime).count();
+}
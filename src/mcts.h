@@ -0,0 +1,200 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "board.h"
+#include "search.h"
+#include "timeman.h"
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+// Leaf evaluator: value of a position in [-1, 1] from the side to move's point of view.
+// Called concurrently from all worker threads, so it must be thread-safe.
+using LeafEvaluator = std::function<float(const Board&)>;
+
+// Visits per search when no node or time limit is given
+constexpr uint64_t DEFAULT_MCTS_VISITS = 800;
+
+// Memory the search tree may use before it stops growing
+constexpr size_t DEFAULT_MCTS_HASH_MB = 256;
+
+// Node of the search tree. Statistics are atomics so threads can walk the tree
+// without locks; a node's children are created once, by the thread that wins
+// the race to expand it, and never change afterwards.
+struct MCTSNode {
+    enum State : uint8_t { UNEXPANDED, EXPANDING, EXPANDED };
+
+    // Move leading to this node and its prior probability
+    Move move;
+    float prior = 0.0f;
+
+    // Completed visits and the sum of their values, seen by the side that played the move
+    std::atomic<uint32_t> visits{0};
+    std::atomic<float> valueSum{0.0f};
+
+    // Visits in flight, counted as losses to steer other threads elsewhere
+    std::atomic<uint32_t> virtualLoss{0};
+
+    // Expansion state, children are only read once it is EXPANDED
+    std::atomic<uint8_t> state{UNEXPANDED};
+
+    // Game over at this node (no children) and its value for the side that played the move
+    bool terminal = false;
+    float terminalValue = 0.0f;
+
+    std::unique_ptr<MCTSNode[]> children;
+    int numChildren = 0;
+
+    // Average value, 0 if unvisited
+    float q() const;
+};
+
+// Tunables of the Monte Carlo tree search
+struct MCTSOptions {
+    // Number of worker threads expanding the shared tree
+    int threads = 1;
+
+    // Visits per search when neither a node nor a time limit is given
+    uint64_t visits = DEFAULT_MCTS_VISITS;
+
+    // Exploration constant of the PUCT formula
+    float cpuct = 1.5f;
+
+    // Number of pending losses added to a node while a thread is below it
+    int virtualLoss = 3;
+
+    // Start from the previous search's subtree when the position is found in it
+    bool reuseTree = true;
+
+    // Most nodes in the tree (reused ones included); the search stops when an
+    // expansion would exceed it
+    uint64_t maxNodes = DEFAULT_MCTS_HASH_MB * 1024 * 1024 / sizeof(MCTSNode);
+};
+
+// Multi-threaded Monte Carlo tree search with PUCT selection
+class MCTS {
+public:
+    // Constructor
+    MCTS();
+
+    // Search a position and return the most visited move
+    SearchResult run(const Board& board, const SearchLimits& limits);
+
+    // Set the function that evaluates leaves (the handcrafted evaluation by default)
+    void setEvaluator(LeafEvaluator evaluator);
+
+    // Forget the tree of the previous search (for a new game)
+    void clear();
+
+    // Tree of the last search (nullptr before the first one)
+    const MCTSNode* root() const { return _root.get(); }
+
+    // Set the function that receives progress during the search
+    void setInfoCallback(SearchInfoCallback callback);
+
+    // Limit the tree to about sizeMb megabytes of nodes
+    void setHashSize(size_t sizeMb);
+
+    // Number of nodes in the tree of the last search
+    uint64_t treeNodes() const { return _treeNodes; }
+
+    // Access the tunables
+    MCTSOptions& options() { return _options; }
+    const MCTSOptions& options() const { return _options; }
+
+    // Ask a running search to stop as soon as possible (thread-safe)
+    void stop() { _stopRequested = true; }
+
+    // Turn a pondering search into a normal timed search (thread-safe)
+    void ponderhit() { _ponderhitRequested = true; }
+
+    // Clear previous stop and ponderhit requests before starting a new search
+    void clearRequests() {
+        _stopRequested = false;
+        _ponderhitRequested = false;
+    }
+
+    // Check if a stop has been requested
+    bool stopRequested() const { return _stopRequested; }
+
+    // Check if a ponderhit has been received
+    bool ponderhitReceived() const { return _ponderhitRequested; }
+
+    // Access the time manager
+    TimeManager& timeManager() { return _timeManager; }
+
+    // Default evaluator: the handcrafted evaluation squashed into [-1, 1]
+    static float staticEvaluator(const Board& board);
+
+    // Convert a value in [-1, 1] to centipawns
+    static int valueToCentipawns(float value);
+
+private:
+    // Take the subtree of a position from the previous tree, at most two plies below its
+    // root (nullptr if the position isn't there)
+    std::unique_ptr<MCTSNode> reuseTree(const Board& board);
+
+    // Worker loop: run simulations until the search stops
+    void worker();
+
+    // Walk from the root to a leaf, evaluate it and back up the value.
+    // Returns false if the simulation collided with another thread's expansion.
+    bool simulate();
+
+    // Create the children of a node and return the value of its position for the side to move.
+    // A full tree leaves the node without children and stops the search.
+    float expand(MCTSNode& node, const Board& board);
+
+    // Number of nodes in a subtree
+    static uint64_t countNodes(const MCTSNode& node);
+
+    // Pick the child with the highest PUCT score
+    MCTSNode* selectChild(MCTSNode& node) const;
+
+    // Report the current principal variation
+    void sendInfo() const;
+
+    // Most visited child of a node (nullptr if none was visited)
+    static const MCTSNode* bestChild(const MCTSNode& node);
+
+    // Milliseconds since the search started
+    int64_t elapsedMs() const;
+
+    // Tunables and leaf evaluator
+    MCTSOptions _options;
+    LeafEvaluator _evaluator;
+    SearchInfoCallback _infoCallback;
+
+    // Tree of the current search
+    std::unique_ptr<MCTSNode> _root;
+    Board _rootBoard;
+
+    // Limits of the current search
+    SearchLimits _limits;
+    TimeManager _timeManager;
+    uint64_t _visitBudget;
+
+    // Set by another thread to interrupt the search
+    std::atomic<bool> _stopRequested;
+
+    // Set by another thread when the opponent played the expected move
+    std::atomic<bool> _ponderhitRequested;
+
+    // Whether the search is still pondering (limits not started yet)
+    std::atomic<bool> _pondering;
+
+    // Set when the workers must finish (stop request or limit reached)
+    std::atomic<bool> _stop;
+
+    // Statistics of the current search
+    std::atomic<uint64_t> _simulations;
+    std::atomic<uint64_t> _treeNodes;
+    std::atomic<uint64_t> _depthSum;
+    std::atomic<int> _selDepth;
+    std::chrono::steady_clock::time_point _startTime;
+};
+
+#endif // MCTS_H
@@ -1,5 +1,6 @@
 #include "neural_network.h"
 #include <cmath>
+#include <utility>
 
 void NeuronLayer::initialize(int inputSize, int outputSize, std::mt19937& rng) {
     std::uniform_real_distribution<float> dist(-0.1f, 0.1f);
@@ -26,6 +27,23 @@ NeuralNetwork::NeuralNetwork(const std::vector<int>& topology) {
         layer.initialize(topology[i], topology[i + 1], rng);
         layers.push_back(layer);
     }
+    rebuildFirstLayerColumns();
+}
+
+void NeuralNetwork::rebuildFirstLayerColumns() {
+    if (layers.empty()) {
+        firstLayerColumns.clear();
+        return;
+    }
+    const NeuronLayer& layer = layers[0];
+    const size_t neurons = layer.weights.size();
+    const size_t inputs = inputSize();
+    firstLayerColumns.resize(inputs * neurons);
+    for (size_t i = 0; i < neurons; i++) {
+        for (size_t j = 0; j < inputs; j++) {
+            firstLayerColumns[j * neurons + i] = layer.weights[i][j];
+        }
+    }
 }
 
 float NeuralNetwork::forward(const std::vector<float>& inputs) {
@@ -58,6 +76,98 @@ float NeuralNetwork::forward(const std::vector<float>& inputs) {
     return layers.back().outputs[0];
 }
 
+float NeuralNetwork::evaluate(const std::vector<float>& inputs) const {
+    return evaluateLayers(inputs, 0);
+}
+
+float NeuralNetwork::evaluateLayers(std::vector<float> current, size_t first) const {
+    std::vector<float> next;
+    
+    for (size_t l = first; l < layers.size(); l++) {
+        const NeuronLayer& layer = layers[l];
+        next.resize(layer.biases.size());
+        
+        for (size_t i = 0; i < next.size(); i++) {
+            float sum = layer.biases[i];
+            const std::vector<float>& weights = layer.weights[i];
+            for (size_t j = 0; j < current.size(); j++) {
+                sum += current[j] * weights[j];
+            }
+            // Last layer uses no activation (for value output)
+            next[i] = (l == layers.size() - 1) ? sum : tanh(sum);
+        }
+        
+        current.swap(next);
+    }
+    
+    return current[0];
+}
+
+void NeuralNetwork::addFirstLayerColumn(std::vector<float>& preActivations, size_t input, float scale) const {
+    const float* column = firstLayerColumns.data() + input * preActivations.size();
+    for (size_t i = 0; i < preActivations.size(); i++) {
+        preActivations[i] += scale * column[i];
+    }
+}
+
+float NeuralNetwork::evaluateFromFirstLayer(const std::vector<float>& preActivations) const {
+    // A single layer network has no activation on its output
+    if (layers.size() == 1) {
+        return preActivations[0];
+    }
+    
+    std::vector<float> current(preActivations.size());
+    for (size_t i = 0; i < current.size(); i++) {
+        current[i] = tanh(preActivations[i]);
+    }
+    return evaluateLayers(std::move(current), 1);
+}
+
+std::vector<float> NeuralNetwork::evaluateBatch(const std::vector<std::vector<float>>& inputs) const {
+    std::vector<float> rows;
+    rows.reserve(inputs.size() * inputSize());
+    for (const std::vector<float>& input : inputs) {
+        rows.insert(rows.end(), input.begin(), input.end());
+    }
+    
+    std::vector<float> outputs(inputs.size());
+    evaluateBatch(rows.data(), inputs.size(), outputs.data());
+    return outputs;
+}
+
+void NeuralNetwork::evaluateBatch(const float* inputs, size_t count, float* outputs) const {
+    size_t width = inputSize();
+    std::vector<float> current(inputs, inputs + count * width);
+    std::vector<float> next;
+    
+    for (size_t l = 0; l < layers.size(); l++) {
+        const NeuronLayer& layer = layers[l];
+        const size_t neurons = layer.biases.size();
+        next.resize(count * neurons);
+        
+        // Neuron-major order keeps the weight row in cache while it is applied to every input
+        for (size_t i = 0; i < neurons; i++) {
+            const float* weights = layer.weights[i].data();
+            for (size_t b = 0; b < count; b++) {
+                const float* input = current.data() + b * width;
+                float sum = layer.biases[i];
+                for (size_t j = 0; j < width; j++) {
+                    sum += input[j] * weights[j];
+                }
+                // Last layer uses no activation (for value output)
+                next[b * neurons + i] = (l == layers.size() - 1) ? sum : tanh(sum);
+            }
+        }
+        
+        current.swap(next);
+        width = neurons;
+    }
+    
+    for (size_t b = 0; b < count; b++) {
+        outputs[b] = current[b * width];
+    }
+}
+
 void NeuralNetwork::backpropagate(const std::vector<float>& inputs, float target, float learningRate) {
     // Forward pass
     forward(inputs);
@@ -89,11 +199,14 @@ void NeuralNetwork::backpropagate(const std::vector<float>& inputs, float target
     }
     
     // Update weights and biases
-    // First layer
-    for (size_t i = 0; i < layers[0].outputs.size(); i++) {
+    // First layer, keeping its input-major copy in step
+    const size_t neurons = layers[0].outputs.size();
+    for (size_t i = 0; i < neurons; i++) {
         layers[0].biases[i] += learningRate * deltas[0][i];
         for (size_t j = 0; j < inputs.size(); j++) {
-            layers[0].weights[i][j] += learningRate * deltas[0][i] * inputs[j];
+            float& weight = layers[0].weights[i][j];
+            weight += learningRate * deltas[0][i] * inputs[j];
+            firstLayerColumns[j * neurons + i] = weight;
         }
     }
     
@@ -180,5 +293,6 @@ bool NeuralNetwork::load(const std::string& filename) {
         layers.push_back(layer);
     }
     
+    rebuildFirstLayerColumns();
     return true;
 }
\ No newline at end of file
@@ -19,6 +19,16 @@ class NeuralNetwork {
 private:
     std::vector<NeuronLayer> layers;
     std::mt19937 rng;
+    
+    // First layer weights stored input by input, so the weights of one input are contiguous
+    std::vector<float> firstLayerColumns;
+    
+    // Copy the first layer weights into firstLayerColumns once they are created or
+    // loaded (backpropagate keeps the copy up to date itself)
+    void rebuildFirstLayerColumns();
+    
+    // Run the layers from index first on, given the inputs of that layer (thread-safe)
+    float evaluateLayers(std::vector<float> current, size_t first) const;
 
 public:
     NeuralNetwork(const std::vector<int>& topology);
@@ -26,6 +36,27 @@ public:
     // Forward pass through the network
     float forward(const std::vector<float>& inputs);
     
+    // Forward pass that doesn't touch the layer outputs, safe to call from many threads
+    float evaluate(const std::vector<float>& inputs) const;
+    
+    // Thread-safe forward pass over a batch of inputs, reusing each weight row for the whole batch
+    std::vector<float> evaluateBatch(const std::vector<std::vector<float>>& inputs) const;
+    
+    // Batched forward pass over count rows of inputSize() values stored one after another
+    void evaluateBatch(const float* inputs, size_t count, float* outputs) const;
+    
+    // Number of inputs of the network
+    size_t inputSize() const { return layers[0].weights.empty() ? 0 : layers[0].weights[0].size(); }
+    
+    // Biases of the first layer, the starting point of its pre-activations
+    const std::vector<float>& firstLayerBiases() const { return layers[0].biases; }
+    
+    // Add scale times the first layer weights of one input to a set of pre-activations
+    void addFirstLayerColumn(std::vector<float>& preActivations, size_t input, float scale) const;
+    
+    // Finish a forward pass from the first layer's pre-activations (thread-safe)
+    float evaluateFromFirstLayer(const std::vector<float>& preActivations) const;
+    
     // Update weights using backpropagation
     void backpropagate(const std::vector<float>& inputs, float target, float learningRate);
     
@@ -0,0 +1,206 @@
+#include "pawns.h"
+#include "board.h"
+#include <algorithm>
+#include <memory>
+
+namespace {
+    using Eval::Score;
+
+    // Pawn structure terms
+    constexpr Score DOUBLED_PAWN = Score(-10, -20);
+    constexpr Score ISOLATED_PAWN = Score(-12, -15);
+    constexpr Score BACKWARD_PAWN = Score(-8, -12);
+    constexpr Score PASSED_PAWN[8] = {
+        Score(0, 0), Score(5, 10), Score(5, 15), Score(10, 25),
+        Score(25, 45), Score(45, 80), Score(70, 120), Score(0, 0)
+    };
+
+    // King shelter per file next to the king: shield pawn on the second or third rank,
+    // a pawn further up the board, or no pawn at all
+    constexpr Score SHIELD_SECOND_RANK = Score(25, 0);
+    constexpr Score SHIELD_THIRD_RANK = Score(12, 0);
+    constexpr Score SHIELD_ADVANCED = Score(-10, 0);
+    constexpr Score SHIELD_MISSING = Score(-25, 0);
+
+    struct PawnMasks {
+        // Squares in front of a pawn on its own and the adjacent files, indexed by [color][square]
+        std::array<std::array<Bitboard, 64>, 2> passed{};
+
+        // Files on either side of a file
+        std::array<Bitboard, 8> adjacentFiles{};
+
+        // Ranks strictly in front of a rank, indexed by [color][rank]
+        std::array<std::array<Bitboard, 8>, 2> ranksAhead{};
+    };
+
+    constexpr PawnMasks generatePawnMasks() {
+        PawnMasks masks;
+        for (int file = 0; file < 8; ++file) {
+            for (int other = 0; other < 8; ++other) {
+                if (other == file - 1 || other == file + 1) {
+                    for (int rank = 0; rank < 8; ++rank) {
+                        masks.adjacentFiles[file] |= 1ULL << (rank * 8 + other);
+                    }
+                }
+            }
+        }
+        for (int rank = 0; rank < 8; ++rank) {
+            for (int r = 0; r < 8; ++r) {
+                Bitboard rankMask = 0xFFULL << (r * 8);
+                if (r > rank) masks.ranksAhead[WHITE][rank] |= rankMask;
+                if (r < rank) masks.ranksAhead[BLACK][rank] |= rankMask;
+            }
+        }
+        for (int sq = 0; sq < 64; ++sq) {
+            int file = sq % 8;
+            int rank = sq / 8;
+            Bitboard files = masks.adjacentFiles[file] | (0x0101010101010101ULL << file);
+            masks.passed[WHITE][sq] = files & masks.ranksAhead[WHITE][rank];
+            masks.passed[BLACK][sq] = files & masks.ranksAhead[BLACK][rank];
+        }
+        return masks;
+    }
+
+    constexpr PawnMasks PAWN_MASKS = generatePawnMasks();
+
+    // Doubled, isolated, backward and passed pawns of a color
+    Score evaluateColor(const Board& board, Color us, Pawns::Entry& entry) {
+        Bitboard ourPawns = board._pieces[us][PAWN];
+        Bitboard passed = Pawns::passed(board, us);
+        Bitboard backward = Pawns::backward(board, us);
+
+        Score score;
+        Bitboard pawns = ourPawns;
+        while (pawns) {
+            Square sq = BitboardUtils::lsb(pawns);
+            pawns &= pawns - 1;
+            int file = BitboardUtils::squareFile(sq);
+            int rank = BitboardUtils::squareRank(sq);
+            Bitboard ahead = PAWN_MASKS.passed[us][sq] & BitboardConstants::FILE_MASKS[file];
+
+            // Count each doubled pawn once, on the rearmost pawn of the file
+            if (ourPawns & ahead) {
+                score += DOUBLED_PAWN;
+            }
+
+            if (!(ourPawns & PAWN_MASKS.adjacentFiles[file])) {
+                score += ISOLATED_PAWN;
+            } else if (backward & (1ULL << sq)) {
+                score += BACKWARD_PAWN;
+            }
+
+            if (passed & (1ULL << sq)) {
+                int relativeRank = us == WHITE ? rank : 7 - rank;
+                score += PASSED_PAWN[relativeRank];
+            }
+        }
+
+        // Shelter for a king on each file, looking at that file and its neighbours
+        for (int kingFile = 0; kingFile < 8; ++kingFile) {
+            Score shelter;
+            for (int file = std::max(kingFile - 1, 0); file <= std::min(kingFile + 1, 7); ++file) {
+                Bitboard filePawns = ourPawns & BitboardConstants::FILE_MASKS[file];
+                Bitboard secondRank = BitboardConstants::RANK_MASKS[us == WHITE ? RANK_2 : RANK_7];
+                Bitboard thirdRank = BitboardConstants::RANK_MASKS[us == WHITE ? RANK_3 : RANK_6];
+                if (filePawns & secondRank) {
+                    shelter += SHIELD_SECOND_RANK;
+                } else if (filePawns & thirdRank) {
+                    shelter += SHIELD_THIRD_RANK;
+                } else if (filePawns) {
+                    shelter += SHIELD_ADVANCED;
+                } else {
+                    shelter += SHIELD_MISSING;
+                }
+            }
+            entry.shelter[us][kingFile] = shelter;
+        }
+
+        return score;
+    }
+}
+
+namespace Pawns {
+    Bitboard attacks(Bitboard pawns, Color color) {
+        const Bitboard notFileA = ~BitboardConstants::FILE_MASKS[FILE_A];
+        const Bitboard notFileH = ~BitboardConstants::FILE_MASKS[FILE_H];
+        if (color == WHITE) {
+            return ((pawns & notFileA) << 7) | ((pawns & notFileH) << 9);
+        }
+        return ((pawns & notFileA) >> 9) | ((pawns & notFileH) >> 7);
+    }
+
+    Bitboard passed(const Board& board, Color color) {
+        Bitboard ourPawns = board._pieces[color][PAWN];
+        Bitboard theirPawns = board._pieces[1 - color][PAWN];
+
+        Bitboard passed = 0;
+        for (Bitboard pawns = ourPawns; pawns; pawns &= pawns - 1) {
+            Square sq = BitboardUtils::lsb(pawns);
+            Bitboard ahead = PAWN_MASKS.passed[color][sq] & BitboardConstants::FILE_MASKS[BitboardUtils::squareFile(sq)];
+            if (!(theirPawns & PAWN_MASKS.passed[color][sq]) && !(ourPawns & ahead)) {
+                passed |= 1ULL << sq;
+            }
+        }
+        return passed;
+    }
+
+    Bitboard backward(const Board& board, Color color) {
+        Color them = Color(1 - color);
+        Bitboard ourPawns = board._pieces[color][PAWN];
+        Bitboard theirAttacks = attacks(board._pieces[them][PAWN], them);
+
+        Bitboard backward = 0;
+        for (Bitboard pawns = ourPawns; pawns; pawns &= pawns - 1) {
+            Square sq = BitboardUtils::lsb(pawns);
+            Bitboard neighbours = ourPawns & PAWN_MASKS.adjacentFiles[BitboardUtils::squareFile(sq)];
+
+            // With every neighbour advanced past it, it can't be defended by a pawn,
+            // and it can't safely advance either
+            Square stop = static_cast<Square>(color == WHITE ? sq + 8 : sq - 8);
+            if (neighbours && !(neighbours & ~PAWN_MASKS.ranksAhead[color][BitboardUtils::squareRank(sq)]) &&
+                (theirAttacks & (1ULL << stop))) {
+                backward |= 1ULL << sq;
+            }
+        }
+        return backward;
+    }
+
+    void evaluate(const Board& board, Entry& entry) {
+        entry.key = board.pawnHash();
+        entry.score = evaluateColor(board, WHITE, entry) - evaluateColor(board, BLACK, entry);
+    }
+
+    Table::Table(size_t entries) : _hits(0), _probes(0) {
+        // Largest power of two not above the requested size
+        size_t count = 1;
+        while (count * 2 <= entries) {
+            count *= 2;
+        }
+        _entries.resize(count);
+        _mask = count - 1;
+    }
+
+    const Entry& Table::probe(const Board& board) {
+        _probes++;
+        Entry& entry = _entries[board.pawnHash() & _mask];
+        if (entry.key == board.pawnHash()) {
+            _hits++;
+            return entry;
+        }
+
+        Pawns::evaluate(board, entry);
+        return entry;
+    }
+
+    void Table::clear() {
+        std::fill(_entries.begin(), _entries.end(), Entry());
+        _hits = 0;
+        _probes = 0;
+    }
+
+    const Entry& probe(const Board& board) {
+        // Searches evaluate from several threads, so each thread has its own table
+        thread_local std::unique_ptr<Table> table = std::make_unique<Table>();
+        return table->probe(board);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef PAWNS_H
+#define PAWNS_H
+
+#include "bitboard.h"
+#include "zobrist.h"
+#include "evaluate.h"
+#include <vector>
+#include <cstdint>
+
+class Board;
+
+// Pawn structure evaluation, cached by the pawn-only hash key
+namespace Pawns {
+    // Default number of entries per pawn hash table (power of two)
+    constexpr size_t DEFAULT_TABLE_ENTRIES = 16384;
+
+    // Everything about a pawn structure that doesn't depend on the other pieces
+    struct Entry {
+        HashKey key = ~HashKey(0);
+
+        // Doubled, isolated, backward and passed pawns, from White's point of view
+        Eval::Score score;
+
+        // Pawn shield in front of a castled king of each color, by king file
+        Eval::Score shelter[2][8];
+    };
+
+    // Hash table of evaluated pawn structures (not thread-safe, use one per thread)
+    class Table {
+    public:
+        explicit Table(size_t entries = DEFAULT_TABLE_ENTRIES);
+
+        // Get the entry for the board's pawn structure, evaluating it on a miss
+        const Entry& probe(const Board& board);
+
+        // Forget all entries
+        void clear();
+
+        // Lookup statistics
+        uint64_t hits() const { return _hits; }
+        uint64_t probes() const { return _probes; }
+
+    private:
+        std::vector<Entry> _entries;
+        size_t _mask;
+        uint64_t _hits;
+        uint64_t _probes;
+    };
+
+    // Evaluate a pawn structure from scratch
+    void evaluate(const Board& board, Entry& entry);
+
+    // Probe the calling thread's own table
+    const Entry& probe(const Board& board);
+
+    // Squares attacked by a set of pawns of the given color
+    Bitboard attacks(Bitboard pawns, Color color);
+
+    // Pawns of a color with no enemy pawn in front on their own or an adjacent file,
+    // and not blocked by one of their own
+    Bitboard passed(const Board& board, Color color);
+
+    // Pawns of a color whose neighbours have all advanced past them and whose
+    // stop square is attacked by an enemy pawn
+    Bitboard backward(const Board& board, Color color);
+}
+
+#endif // PAWNS_H
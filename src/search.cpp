@@ -0,0 +1,780 @@
+#include "search.h"
+#include "movegen.h"
+#include "bitbase.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // Material values used by move ordering and delta pruning
+    const int PIECE_VALUES[7] = {100, 320, 330, 500, 900, 0, 0};
+
+    // Margins for futility pruning, indexed by depth
+    const int FUTILITY_MARGINS[4] = {0, 200, 300, 500};
+
+    // Margin per ply for reverse futility pruning
+    const int REVERSE_FUTILITY_MARGIN = 120;
+
+    // Initial half-width of the root aspiration window
+    const int ASPIRATION_WINDOW = 25;
+
+    // Number of nodes between clock checks (power of two)
+    const uint64_t TIME_CHECK_INTERVAL = 1024;
+
+    // Move ordering score bands
+    const int TT_MOVE_SCORE = 1000000;
+    const int CAPTURE_SCORE = 100000;
+    const int KILLER_SCORE = 90000;
+
+    // History scores are kept below the killer band
+    const int HISTORY_MAX = 16384;
+
+    // Get the piece captured by a move (NO_PIECE_TYPE for quiet moves)
+    PieceType capturedPiece(const Board& board, const Move& move, PieceType movingPiece) {
+        Color color;
+        PieceType captured = board.pieceAt(move.to, color);
+        if (captured == NO_PIECE_TYPE && movingPiece == PAWN && move.to == board.enPassantSquare()) {
+            return PAWN;
+        }
+        return captured;
+    }
+
+    // Check if a move changes material (captures and promotions)
+    bool isTactical(const Board& board, const Move& move) {
+        if (move.promotion != NO_PIECE_TYPE) {
+            return true;
+        }
+        Color color;
+        PieceType moving = board.pieceAt(move.from, color);
+        return capturedPiece(board, move, moving) != NO_PIECE_TYPE;
+    }
+
+    // Convert a score to and from the transposition table, where mate scores
+    // are stored relative to the node instead of the root
+    int scoreToTT(int score, int ply) {
+        if (score >= VALUE_MATE_IN_MAX_PLY) return score + ply;
+        if (score <= -VALUE_MATE_IN_MAX_PLY) return score - ply;
+        return score;
+    }
+
+    int scoreFromTT(int score, int ply) {
+        if (score >= VALUE_MATE_IN_MAX_PLY) return score - ply;
+        if (score <= -VALUE_MATE_IN_MAX_PLY) return score + ply;
+        return score;
+    }
+}
+
+Search::Search() : _stopRequested(false), _ponderhitRequested(false), _pondering(false), _rootColor(WHITE), _stop(false), _multiPv(1), _probeBitbases(false), _nodes(0), _tbHits(0), _selDepth(0), _rootDepth(0), _lastInfoMs(0) {
+    // Reductions grow with the logarithm of both depth and move number
+    for (int depth = 0; depth < 64; ++depth) {
+        for (int moveNumber = 0; moveNumber < 64; ++moveNumber) {
+            if (depth == 0 || moveNumber == 0) {
+                _reductions[depth][moveNumber] = 0;
+            } else {
+                _reductions[depth][moveNumber] =
+                    static_cast<int>(0.75 + std::log(depth) * std::log(moveNumber) / 2.25);
+            }
+        }
+    }
+
+    clear();
+}
+
+void Search::setInfoCallback(SearchInfoCallback callback) {
+    _infoCallback = callback;
+}
+
+void Search::setHashSize(size_t sizeMb) {
+    _tt.resize(sizeMb);
+}
+
+void Search::clear() {
+    _tt.clear();
+    std::memset(_history, 0, sizeof(_history));
+    for (int ply = 0; ply < MAX_PLY; ++ply) {
+        _killers[ply][0] = Move();
+        _killers[ply][1] = Move();
+    }
+}
+
+int Search::evaluate(const Board& board) {
+    return Eval::evaluate(board);
+}
+
+SearchResult Search::run(const Board& board, const SearchLimits& limits) {
+    SearchResult result;
+
+    _nodes = 0;
+    _tbHits = 0;
+    _stop = false;
+    _limits = limits;
+    _rootColor = board.sideToMove();
+    _startTime = std::chrono::steady_clock::now();
+    _lastInfoMs = 0;
+    _tt.newSearch();
+
+    // While pondering the clock isn't ours, so time limits start at ponderhit
+    _pondering = limits.ponder && !_ponderhitRequested;
+    SearchLimits timeLimits = limits;
+    timeLimits.infinite = limits.infinite || _pondering;
+    _timeManager.start(timeLimits, _rootColor);
+
+    // Killers from the previous search refer to different plies
+    for (int ply = 0; ply < MAX_PLY; ++ply) {
+        _killers[ply][0] = Move();
+        _killers[ply][1] = Move();
+    }
+
+    // Fall back to the first legal move if the search can't complete an iteration
+    std::vector<Move> rootMoves = board.generateLegalMoves();
+    if (rootMoves.empty()) {
+        return result;
+    }
+    filterRootMoves(board, rootMoves);
+    result.bestMove = rootMoves[0];
+
+    uint64_t previousIterationNodes = 0;
+    int maxDepth = std::min(limits.depth, MAX_PLY - 1);
+
+    // A mate in N moves is found within 2N-1 plies, leave some room for pruning
+    if (limits.mate > 0) {
+        maxDepth = std::min(maxDepth, 2 * limits.mate + 2);
+    }
+
+    // Best lines of the last completed iteration, best first
+    size_t lineCount = std::min(static_cast<size_t>(_multiPv), rootMoves.size());
+    std::vector<SearchInfo> lines(lineCount);
+
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        uint64_t nodesBefore = _nodes;
+        int64_t iterationStart = elapsedMs();
+        _selDepth = 0;
+        _rootDepth = depth;
+
+        // Each line searches the root without the moves of the lines above it
+        std::vector<SearchInfo> iterationLines(lineCount);
+        _excludedRootMoves.clear();
+        for (size_t line = 0; line < lineCount && !_stop; ++line) {
+            // Aspiration window around the previous score, widened on each fail
+            int previousScore = lines[line].score;
+            int delta = ASPIRATION_WINDOW;
+            int alpha = -VALUE_INFINITE;
+            int beta = VALUE_INFINITE;
+            if (_options.aspirationWindows && depth >= 4 && std::abs(previousScore) < VALUE_MATE_IN_MAX_PLY) {
+                alpha = std::max(previousScore - delta, -VALUE_INFINITE);
+                beta = std::min(previousScore + delta, VALUE_INFINITE);
+            }
+
+            int score;
+            while (true) {
+                score = negamax(board, depth, alpha, beta, 0, false);
+
+                if (_stop) {
+                    break;
+                }
+
+                if (score <= alpha) {
+                    // Fail low: lower alpha and pull beta towards the window center
+                    beta = (alpha + beta) / 2;
+                    alpha = std::max(score - delta, -VALUE_INFINITE);
+                } else if (score >= beta) {
+                    // Fail high: raise beta
+                    beta = std::min(score + delta, VALUE_INFINITE);
+                } else {
+                    break;
+                }
+
+                delta += delta / 2;
+            }
+
+            SearchInfo& info = iterationLines[line];
+            info.depth = depth;
+            info.score = score;
+            info.pv.assign(_pvTable[0], _pvTable[0] + _pvLength[0]);
+            if (info.pv.empty()) {
+                // No move to exclude for the next line
+                iterationLines.resize(std::max<size_t>(line, 1));
+                break;
+            }
+            _excludedRootMoves.push_back(info.pv[0]);
+        }
+        _excludedRootMoves.clear();
+
+        // The interrupted iteration is incomplete, keep the previous result
+        if (_stop) {
+            break;
+        }
+
+        // A line may have scored above the one searched before it
+        std::stable_sort(iterationLines.begin(), iterationLines.end(),
+                         [](const SearchInfo& a, const SearchInfo& b) { return a.score > b.score; });
+
+        uint64_t iterationNodes = _nodes - nodesBefore;
+        double branchingFactor = previousIterationNodes > 0
+            ? static_cast<double>(iterationNodes) / previousIterationNodes : 0.0;
+        int score = iterationLines[0].score;
+
+        // Record the result of the completed iteration
+        if (!iterationLines[0].pv.empty()) {
+            result.bestMove = iterationLines[0].pv[0];
+            result.ponderMove = iterationLines[0].pv.size() > 1 ? iterationLines[0].pv[1] : Move();
+        }
+        result.score = score;
+        result.depth = depth;
+        result.nodes = _nodes;
+        result.pv = iterationLines[0].pv;
+        std::copy(iterationLines.begin(), iterationLines.end(), lines.begin());
+
+        if (_infoCallback) {
+            int64_t timeMs = elapsedMs();
+            int hashfull = _tt.hashfull();
+            for (size_t line = 0; line < iterationLines.size(); ++line) {
+                SearchInfo info = iterationLines[line];
+                info.selDepth = _selDepth;
+                info.nodes = _nodes;
+                info.timeMs = timeMs;
+                info.multiPv = static_cast<int>(line) + 1;
+                info.hashfull = hashfull;
+                info.tbHits = _tbHits;
+                info.branchingFactor = line == 0 ? branchingFactor : 0.0;
+                _infoCallback(info);
+            }
+            _lastInfoMs = timeMs;
+        }
+
+        previousIterationNodes = iterationNodes;
+
+        // No need to search deeper once a forced mate has been found
+        if (std::abs(score) >= VALUE_MATE_IN_MAX_PLY && VALUE_MATE - std::abs(score) <= depth) {
+            break;
+        }
+
+        // Mate search: stop once a short enough mate is found
+        if (limits.mate > 0 && score >= VALUE_MATE - (2 * limits.mate - 1)) {
+            break;
+        }
+
+        // Don't start an iteration that can't finish in time
+        checkLimits();
+        int64_t iterationMs = elapsedMs() - iterationStart;
+        if (!_timeManager.canStartIteration(iterationMs, branchingFactor)) {
+            break;
+        }
+    }
+
+    // Without a second PV move, take the expected reply from the transposition table
+    if (result.bestMove.isValid() && !result.ponderMove.isValid()) {
+        Board next = board;
+        if (next.makeMove(result.bestMove)) {
+            const TTEntry* entry = _tt.probe(next.hash());
+            if (entry) {
+                Move reply = Move::unpack(entry->move);
+                for (const Move& move : next.generateLegalMoves()) {
+                    if (move == reply) {
+                        result.ponderMove = reply;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+int Search::negamax(const Board& board, int depth, int alpha, int beta, int ply, bool allowNull) {
+    _pvLength[ply] = 0;
+
+    if (depth <= 0) {
+        return quiescence(board, alpha, beta, ply);
+    }
+
+    _nodes++;
+    _selDepth = std::max(_selDepth, ply);
+    _pathKeys[ply] = board.hash();
+
+    checkLimits();
+    if (_stop) {
+        return 0;
+    }
+
+    const bool rootNode = (ply == 0);
+    const bool pvNode = (beta - alpha > 1);
+    const Color us = board.sideToMove();
+
+    if (!rootNode) {
+        // Draw by fifty-move rule, repetition or insufficient material
+        if (board.halfmoveClock() >= 100 || isRepetition(board, ply) || board.isInsufficientMaterial()) {
+            return VALUE_DRAW;
+        }
+
+        if (ply >= MAX_PLY - 1) {
+            return evaluate(board);
+        }
+
+        // Endgame bitbases: the result is known, scored so that shorter paths to it are preferred
+        Bitbases::WDL wdl;
+        if (_probeBitbases && BitboardUtils::popCount(board._occupiedSquares) <= Bitbases::maxPieces() &&
+            Bitbases::probe(board, wdl)) {
+            _tbHits++;
+            if (wdl == Bitbases::WIN) return VALUE_BITBASE_WIN - ply;
+            if (wdl == Bitbases::LOSS) return -VALUE_BITBASE_WIN + ply;
+            return VALUE_DRAW;
+        }
+
+        // Mate distance pruning
+        alpha = std::max(alpha, -VALUE_MATE + ply);
+        beta = std::min(beta, VALUE_MATE - ply - 1);
+        if (alpha >= beta) {
+            return alpha;
+        }
+    }
+
+    // Transposition table lookup
+    const TTEntry* ttEntry = _tt.probe(board.hash());
+    Move ttMove = ttEntry ? Move::unpack(ttEntry->move) : Move();
+    if (ttEntry && !pvNode && ttEntry->depth >= depth) {
+        int ttScore = scoreFromTT(ttEntry->score, ply);
+        BoundType bound = ttEntry->bound();
+        if (bound == BOUND_EXACT ||
+            (bound == BOUND_LOWER && ttScore >= beta) ||
+            (bound == BOUND_UPPER && ttScore <= alpha)) {
+            return ttScore;
+        }
+    }
+
+    const bool inCheck = board.isInCheck(us);
+    const int staticEval = inCheck ? -VALUE_INFINITE : evaluate(board);
+    const bool mateBeta = std::abs(beta) >= VALUE_MATE_IN_MAX_PLY;
+    const bool mateAlpha = std::abs(alpha) >= VALUE_MATE_IN_MAX_PLY;
+
+    // Reverse futility pruning: the position is so far above beta that a
+    // shallow search is very unlikely to bring it back down
+    if (_options.futilityPruning && !pvNode && !inCheck && !mateBeta && depth <= 6 &&
+        staticEval - REVERSE_FUTILITY_MARGIN * depth >= beta) {
+        return staticEval;
+    }
+
+    // Null-move pruning: if passing still fails high, the position is good
+    // enough to cut. Zugzwang guards: never without non-pawn material, never
+    // twice in a row, and verify the cutoff with a real search at high depth.
+    if (_options.nullMove && allowNull && !pvNode && !inCheck && !mateBeta && depth >= 3 &&
+        staticEval >= beta && board.hasNonPawnMaterial(us)) {
+        int reduction = 3 + depth / 6 + std::min((staticEval - beta) / 200, 3);
+
+        Board nullBoard = board;
+        nullBoard.makeNullMove();
+        int nullScore = -negamax(nullBoard, depth - 1 - reduction, -beta, -beta + 1, ply + 1, false);
+
+        if (nullScore >= beta) {
+            // Don't return unproven mate scores
+            if (nullScore >= VALUE_MATE_IN_MAX_PLY) {
+                nullScore = beta;
+            }
+
+            if (depth < 10) {
+                return nullScore;
+            }
+
+            int verifyScore = negamax(board, depth - 1 - reduction, beta - 1, beta, ply, false);
+            if (verifyScore >= beta) {
+                return nullScore;
+            }
+        }
+    }
+
+    // Futility pruning: near the horizon, quiet moves can't raise a hopeless eval above alpha
+    const bool futilityPrune = _options.futilityPruning && !pvNode && !inCheck && !mateAlpha &&
+                               depth < 4 && staticEval + FUTILITY_MARGINS[depth] <= alpha;
+
+    std::vector<Move> moves = MoveGenerator::generatePseudoLegalMoves(board);
+    std::vector<int> scores;
+    scoreMoves(board, moves, scores, ttMove, ply);
+
+    std::vector<Move> quietsTried;
+    Move bestMove;
+    int bestScore = -VALUE_INFINITE;
+    int originalAlpha = alpha;
+    int legalMoves = 0;
+
+    for (size_t i = 0; i < moves.size(); ++i) {
+        pickNextMove(moves, scores, i);
+        const Move& move = moves[i];
+
+        if (rootNode && isRootMoveExcluded(move)) {
+            continue;
+        }
+
+        Board child = board;
+        if (!child.makeMove(move)) {
+            continue; // Leaves our king in check
+        }
+        legalMoves++;
+
+        const bool tactical = isTactical(board, move);
+        const bool givesCheck = child.isInCheck(child.sideToMove());
+
+        if (futilityPrune && legalMoves > 1 && !tactical && !givesCheck) {
+            continue;
+        }
+
+        int extension = (_options.checkExtensions && givesCheck) ? 1 : 0;
+        int newDepth = depth - 1 + extension;
+        int score;
+
+        // Late move reductions: quiet moves ordered late are searched
+        // shallower first, and re-searched only if they beat alpha
+        int reduction = 0;
+        if (_options.lateMoveReductions && depth >= 3 && legalMoves > 3 && !tactical &&
+            !inCheck && !givesCheck && !(move == _killers[ply][0]) && !(move == _killers[ply][1])) {
+            reduction = _reductions[std::min(depth, 63)][std::min(legalMoves, 63)];
+
+            // Reduce less in PV nodes and for moves with a good history, more for bad ones
+            if (pvNode) {
+                reduction--;
+            }
+            int history = _history[us][move.from][move.to];
+            if (history > HISTORY_MAX / 2) {
+                reduction--;
+            } else if (history < 0) {
+                reduction++;
+            }
+
+            reduction = std::max(0, std::min(reduction, newDepth - 1));
+        }
+
+        // Principal variation search: the first move gets the full window,
+        // the rest are proven worse with a zero window and re-searched if not
+        if (legalMoves == 1) {
+            score = -negamax(child, newDepth, -beta, -alpha, ply + 1, true);
+        } else {
+            score = -negamax(child, newDepth - reduction, -alpha - 1, -alpha, ply + 1, true);
+            if (score > alpha && reduction > 0) {
+                score = -negamax(child, newDepth, -alpha - 1, -alpha, ply + 1, true);
+            }
+            if (score > alpha && score < beta) {
+                score = -negamax(child, newDepth, -beta, -alpha, ply + 1, true);
+            }
+        }
+
+        if (_stop) {
+            return 0;
+        }
+
+        if (!tactical) {
+            quietsTried.push_back(move);
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+
+            if (score > alpha) {
+                alpha = score;
+
+                // Update the principal variation
+                _pvTable[ply][0] = move;
+                for (int j = 0; j < _pvLength[ply + 1]; ++j) {
+                    _pvTable[ply][j + 1] = _pvTable[ply + 1][j];
+                }
+                _pvLength[ply] = _pvLength[ply + 1] + 1;
+
+                if (alpha >= beta) {
+                    if (!tactical) {
+                        updateQuietStats(board, move, depth, ply, quietsTried);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    // Checkmate or stalemate
+    if (legalMoves == 0) {
+        return inCheck ? -VALUE_MATE + ply : VALUE_DRAW;
+    }
+
+    // Every move was pruned by futility: the static eval is the best estimate
+    if (bestScore == -VALUE_INFINITE) {
+        return staticEval;
+    }
+
+    // Without some of its moves the root result isn't the position's
+    if (!rootNode || _excludedRootMoves.empty()) {
+        BoundType bound = bestScore >= beta ? BOUND_LOWER
+                        : bestScore > originalAlpha ? BOUND_EXACT : BOUND_UPPER;
+        _tt.store(board.hash(), bestMove, scoreToTT(bestScore, ply),
+                  inCheck ? 0 : staticEval, depth, bound);
+    }
+
+    return bestScore;
+}
+
+int Search::quiescence(const Board& board, int alpha, int beta, int ply) {
+    _nodes++;
+    _selDepth = std::max(_selDepth, ply);
+    _pvLength[ply] = 0;
+
+    checkLimits();
+    if (_stop) {
+        return 0;
+    }
+
+    const bool inCheck = board.isInCheck(board.sideToMove());
+
+    if (ply >= MAX_PLY - 1) {
+        return inCheck ? VALUE_DRAW : evaluate(board);
+    }
+
+    // Stand pat: the side to move can usually do at least as well as the static eval
+    int bestScore = -VALUE_INFINITE;
+    int standPat = 0;
+    if (!inCheck) {
+        standPat = evaluate(board);
+        if (standPat >= beta) {
+            return standPat;
+        }
+        alpha = std::max(alpha, standPat);
+        bestScore = standPat;
+    }
+
+    // When in check all evasions are searched, otherwise only captures and promotions
+    std::vector<Move> moves = MoveGenerator::generatePseudoLegalMoves(board);
+    if (!inCheck) {
+        moves.erase(std::remove_if(moves.begin(), moves.end(),
+                                   [&board](const Move& move) { return !isTactical(board, move); }),
+                    moves.end());
+    }
+
+    std::vector<int> scores;
+    scoreMoves(board, moves, scores, Move(), ply);
+
+    int legalMoves = 0;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        pickNextMove(moves, scores, i);
+        const Move& move = moves[i];
+
+        // Delta pruning: skip captures that can't bring the score back to alpha
+        if (!inCheck && move.promotion == NO_PIECE_TYPE) {
+            Color color;
+            PieceType moving = board.pieceAt(move.from, color);
+            PieceType captured = capturedPiece(board, move, moving);
+            if (standPat + PIECE_VALUES[captured] + 200 <= alpha) {
+                continue;
+            }
+        }
+
+        Board child = board;
+        if (!child.makeMove(move)) {
+            continue;
+        }
+        legalMoves++;
+
+        int score = -quiescence(child, -beta, -alpha, ply + 1);
+
+        if (_stop) {
+            return 0;
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+
+    if (inCheck && legalMoves == 0) {
+        return -VALUE_MATE + ply;
+    }
+
+    return bestScore;
+}
+
+int64_t Search::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - _startTime).count();
+}
+
+void Search::checkLimits() {
+    if (_stopRequested.load(std::memory_order_relaxed)) {
+        _stop = true;
+        return;
+    }
+
+    // The opponent played the expected move: the clock is now ours
+    if (_pondering && _ponderhitRequested.load(std::memory_order_relaxed)) {
+        _pondering = false;
+        SearchLimits timeLimits = _limits;
+        timeLimits.ponder = false;
+        _timeManager.start(timeLimits, _rootColor);
+    }
+
+    // Always complete the first iteration so there is a move to play
+    if (_rootDepth <= 1) {
+        return;
+    }
+
+    if (_limits.nodes > 0 && _nodes >= _limits.nodes) {
+        _stop = true;
+    }
+
+    // Reading the clock is comparatively slow, so only do it every few nodes
+    if ((_nodes & (TIME_CHECK_INTERVAL - 1)) == 0) {
+        if (_timeManager.hardLimitReached()) {
+            _stop = true;
+        } else {
+            sendProgress();
+        }
+    }
+}
+
+void Search::sendProgress() {
+    if (!_infoCallback) {
+        return;
+    }
+
+    int64_t now = elapsedMs();
+    if (now - _lastInfoMs < DEFAULT_INFO_INTERVAL_MS) {
+        return;
+    }
+    _lastInfoMs = now;
+
+    SearchInfo info;
+    info.progress = true;
+    info.depth = _rootDepth;
+    info.selDepth = _selDepth;
+    info.nodes = _nodes;
+    info.timeMs = now;
+    info.hashfull = _tt.hashfull();
+    info.tbHits = _tbHits;
+    _infoCallback(info);
+}
+
+void Search::filterRootMoves(const Board& board, std::vector<Move>& rootMoves) {
+    _rootMoves.clear();
+    _probeBitbases = _options.bitbases && Bitbases::maxPieces() > 0;
+
+    Bitbases::WDL rootResult;
+    if (!_probeBitbases || !Bitbases::probe(board, rootResult)) {
+        return;
+    }
+
+    // The bitbases only know wins, draws and losses, not how to make progress. Leave
+    // the search to find the way among the moves that keep the result, without probing.
+    std::vector<Move> kept;
+    for (const Move& move : rootMoves) {
+        Board child = board;
+        child.makeMove(move);
+
+        Bitbases::WDL childResult = Bitbases::DRAW;
+        if (!child.isInsufficientMaterial() && !Bitbases::probe(child, childResult)) {
+            kept.push_back(move); // Converts into an ending without a table
+            continue;
+        }
+        if (-childResult == rootResult) {
+            kept.push_back(move);
+        }
+    }
+
+    _probeBitbases = false;
+    if (!kept.empty() && kept.size() < rootMoves.size()) {
+        rootMoves = kept;
+        _rootMoves = kept;
+    }
+}
+
+bool Search::isRootMoveExcluded(const Move& move) const {
+    if (std::find(_excludedRootMoves.begin(), _excludedRootMoves.end(), move) != _excludedRootMoves.end()) {
+        return true;
+    }
+    return !_rootMoves.empty() && std::find(_rootMoves.begin(), _rootMoves.end(), move) == _rootMoves.end();
+}
+
+bool Search::isRepetition(const Board& board, int ply) const {
+    // Only positions since the last capture or pawn move can repeat: first those on
+    // the search path, then the game's positions before the root
+    int earliest = ply - board.halfmoveClock();
+    for (int i = ply - 2; i >= earliest; i -= 2) {
+        if (i >= 0) {
+            if (_pathKeys[i] == board.hash()) {
+                return true;
+            }
+        } else {
+            int index = static_cast<int>(_gameHistory.size()) + i;
+            if (index < 0) {
+                break;
+            }
+            if (_gameHistory[index] == board.hash()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void Search::scoreMoves(const Board& board, const std::vector<Move>& moves, std::vector<int>& scores,
+                        Move ttMove, int ply) const {
+    scores.resize(moves.size());
+
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const Move& move = moves[i];
+
+        if (move == ttMove) {
+            scores[i] = TT_MOVE_SCORE;
+            continue;
+        }
+
+        Color color;
+        PieceType moving = board.pieceAt(move.from, color);
+        PieceType captured = capturedPiece(board, move, moving);
+
+        if (captured != NO_PIECE_TYPE || move.promotion != NO_PIECE_TYPE) {
+            // Most valuable victim, least valuable attacker
+            int victim = captured != NO_PIECE_TYPE ? PIECE_VALUES[captured] : 0;
+            int promotion = move.promotion != NO_PIECE_TYPE ? PIECE_VALUES[move.promotion] : 0;
+            scores[i] = CAPTURE_SCORE + (victim + promotion) * 8 - PIECE_VALUES[moving] / 10;
+        } else if (move == _killers[ply][0]) {
+            scores[i] = KILLER_SCORE + 1;
+        } else if (move == _killers[ply][1]) {
+            scores[i] = KILLER_SCORE;
+        } else {
+            scores[i] = _history[board.sideToMove()][move.from][move.to];
+        }
+    }
+}
+
+void Search::pickNextMove(std::vector<Move>& moves, std::vector<int>& scores, size_t index) {
+    size_t best = index;
+    for (size_t i = index + 1; i < moves.size(); ++i) {
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+    if (best != index) {
+        std::swap(moves[index], moves[best]);
+        std::swap(scores[index], scores[best]);
+    }
+}
+
+void Search::updateQuietStats(const Board& board, const Move& move, int depth, int ply,
+                              const std::vector<Move>& quietsTried) {
+    // Killer moves
+    if (!(move == _killers[ply][0])) {
+        _killers[ply][1] = _killers[ply][0];
+        _killers[ply][0] = move;
+    }
+
+    // History: reward the cutoff move and penalize the quiet moves tried before it,
+    // with a gravity term that keeps scores within [-HISTORY_MAX, HISTORY_MAX]
+    Color us = board.sideToMove();
+    int bonus = std::min(depth * depth, 400);
+    for (const Move& quiet : quietsTried) {
+        int delta = (quiet == move) ? bonus : -bonus;
+        int& entry = _history[us][quiet.from][quiet.to];
+        entry += delta - entry * std::abs(delta) / HISTORY_MAX;
+    }
+}
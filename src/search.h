@@ -0,0 +1,282 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "board.h"
+#include "transposition.h"
+#include "timeman.h"
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Search constants
+constexpr int MAX_PLY = 128;
+constexpr int VALUE_DRAW = 0;
+constexpr int VALUE_MATE = 32000;
+constexpr int VALUE_INFINITE = 32001;
+constexpr int VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_PLY;
+
+// Score of a position the bitbases prove won, just below the mate scores
+constexpr int VALUE_BITBASE_WIN = VALUE_MATE_IN_MAX_PLY - 1;
+
+// Limits for a single search (zero means no limit)
+struct SearchLimits {
+    // Maximum iterative deepening depth
+    int depth = MAX_PLY - 1;
+
+    // Maximum number of nodes
+    uint64_t nodes = 0;
+
+    // Stop once a mate in this many moves is found
+    int mate = 0;
+
+    // Remaining clock time and increment per move in milliseconds, indexed by color
+    int64_t time[2] = {0, 0};
+    int64_t increment[2] = {0, 0};
+
+    // Moves until the next time control
+    int movesToGo = 0;
+
+    // Exact time to search in milliseconds
+    int64_t moveTime = 0;
+
+    // Search until stopped, ignoring the clock
+    bool infinite = false;
+
+    // Search the expected reply on the opponent's time until ponderhit or stop
+    bool ponder = false;
+};
+
+// Toggles for the selective search techniques (all enabled by default)
+struct SearchOptions {
+    // Null-move pruning
+    bool nullMove = true;
+
+    // Late move reductions
+    bool lateMoveReductions = true;
+
+    // Reverse futility (static null move) and futility pruning
+    bool futilityPruning = true;
+
+    // Extend moves that give check
+    bool checkExtensions = true;
+
+    // Search the root with a narrow window around the previous iteration's score
+    bool aspirationWindows = true;
+
+    // Use the endgame bitbases when they are loaded
+    bool bitbases = true;
+};
+
+// Most root moves reported with MultiPV
+constexpr int MAX_MULTI_PV = 256;
+
+// Interval between progress reports while an iteration is running
+constexpr int64_t DEFAULT_INFO_INTERVAL_MS = 1000;
+
+// Progress information reported after each completed iteration
+struct SearchInfo {
+    int depth = 0;
+    int selDepth = 0;
+    int score = 0;
+    uint64_t nodes = 0;
+    int64_t timeMs = 0;
+
+    // Rank of this line among the root moves (1 for the best move)
+    int multiPv = 1;
+
+    // Permill of the transposition table in use, or -1 for searches without one
+    int hashfull = -1;
+
+    // Positions resolved by the bitbases
+    uint64_t tbHits = 0;
+
+    // Periodic report from inside an unfinished iteration, without score and pv
+    bool progress = false;
+
+    // Nodes of this iteration divided by nodes of the previous one
+    double branchingFactor = 0.0;
+
+    std::vector<Move> pv;
+};
+
+// Final result of a search
+struct SearchResult {
+    Move bestMove;
+    Move ponderMove;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+
+    // Principal variation of the last completed iteration
+    std::vector<Move> pv;
+};
+
+// Function type for receiving search progress
+using SearchInfoCallback = std::function<void(const SearchInfo&)>;
+
+// Iterative deepening principal variation search
+class Search {
+public:
+    // Constructor
+    Search();
+
+    // Search a position and return the best move found
+    SearchResult run(const Board& board, const SearchLimits& limits);
+
+    // Set the hash keys of the game's positions before the root, oldest first,
+    // so that repeating one of them counts as a draw
+    void setGameHistory(const std::vector<HashKey>& keys) { _gameHistory = keys; }
+
+    // Set the function that receives progress after each iteration, and
+    // every DEFAULT_INFO_INTERVAL_MS while a long iteration runs
+    void setInfoCallback(SearchInfoCallback callback);
+
+    // Number of best root moves to search and report, each with its own pv
+    void setMultiPv(int lines) { _multiPv = std::max(lines, 1); }
+    int multiPv() const { return _multiPv; }
+
+    // Access the selective search toggles
+    SearchOptions& options() { return _options; }
+    const SearchOptions& options() const { return _options; }
+
+    // Resize the transposition table
+    void setHashSize(size_t sizeMb);
+
+    // Forget everything learned so far (for a new game)
+    void clear();
+
+    // Ask a running search to stop as soon as possible (thread-safe)
+    void stop() { _stopRequested = true; }
+
+    // Turn a pondering search into a normal timed search (thread-safe)
+    void ponderhit() { _ponderhitRequested = true; }
+
+    // Clear previous stop and ponderhit requests before starting a new search
+    void clearRequests() {
+        _stopRequested = false;
+        _ponderhitRequested = false;
+    }
+
+    // Check if a stop has been requested
+    bool stopRequested() const { return _stopRequested; }
+
+    // Check if a ponderhit has been received
+    bool ponderhitReceived() const { return _ponderhitRequested; }
+
+    // Access the time manager
+    TimeManager& timeManager() { return _timeManager; }
+
+    // Access the transposition table
+    const TranspositionTable& transpositionTable() const { return _tt; }
+
+    // Static evaluation from the side to move's point of view (the handcrafted evaluation)
+    static int evaluate(const Board& board);
+
+private:
+    // Alpha-beta search of a node
+    int negamax(const Board& board, int depth, int alpha, int beta, int ply, bool allowNull);
+
+    // Search captures only until the position is quiet
+    int quiescence(const Board& board, int alpha, int beta, int ply);
+
+    // Stop the search if the time or node limit has been reached
+    void checkLimits();
+
+    // Milliseconds since the search started
+    int64_t elapsedMs() const;
+
+    // Report the node count and table usage if the last report is old enough
+    void sendProgress();
+
+    // Keep the root moves that preserve the bitbase result of a covered root position
+    void filterRootMoves(const Board& board, std::vector<Move>& rootMoves);
+
+    // Check if a move is excluded at the root (by the bitbases or an earlier line)
+    bool isRootMoveExcluded(const Move& move) const;
+
+    // Check if the position repeats one earlier on the search path
+    bool isRepetition(const Board& board, int ply) const;
+
+    // Assign ordering scores to moves
+    void scoreMoves(const Board& board, const std::vector<Move>& moves, std::vector<int>& scores,
+                    Move ttMove, int ply) const;
+
+    // Move the highest scoring remaining move to the given index
+    static void pickNextMove(std::vector<Move>& moves, std::vector<int>& scores, size_t index);
+
+    // Update killers and history after a quiet move caused a beta cutoff
+    void updateQuietStats(const Board& board, const Move& move, int depth, int ply,
+                          const std::vector<Move>& quietsTried);
+
+    // Selective search toggles
+    SearchOptions _options;
+
+    // Transposition table
+    TranspositionTable _tt;
+
+    // Progress callback
+    SearchInfoCallback _infoCallback;
+
+    // Triangular principal variation table
+    Move _pvTable[MAX_PLY][MAX_PLY];
+    int _pvLength[MAX_PLY];
+
+    // Killer moves, two per ply
+    Move _killers[MAX_PLY][2];
+
+    // History heuristic scores, indexed by [color][from][to]
+    int _history[2][64][64];
+
+    // Late move reduction amounts, indexed by [depth][move number]
+    int _reductions[64][64];
+
+    // Hash keys of the positions on the current search path
+    HashKey _pathKeys[MAX_PLY];
+
+    // Hash keys of the game's positions before the root
+    std::vector<HashKey> _gameHistory;
+
+    // Limits of the current search
+    SearchLimits _limits;
+    TimeManager _timeManager;
+
+    // Set by another thread to interrupt the search
+    std::atomic<bool> _stopRequested;
+
+    // Set by another thread when the opponent played the expected move
+    std::atomic<bool> _ponderhitRequested;
+
+    // Whether the search is still pondering (time limits not started yet)
+    bool _pondering;
+    Color _rootColor;
+
+    // Set when the search must unwind (stop request or limit reached)
+    bool _stop;
+
+    // Moves searched at the root when the bitbases restrict them (empty: all moves)
+    std::vector<Move> _rootMoves;
+
+    // Root moves of the lines already found in this iteration, skipped by the next line
+    std::vector<Move> _excludedRootMoves;
+
+    // Number of lines searched at the root
+    int _multiPv;
+
+    // Probe the bitbases inside the tree (off when they already decided the root)
+    bool _probeBitbases;
+
+    // Statistics of the current search
+    uint64_t _nodes;
+    uint64_t _tbHits;
+    int _selDepth;
+    int _rootDepth;
+    std::chrono::steady_clock::time_point _startTime;
+
+    // Time of the last report, to rate-limit progress output
+    int64_t _lastInfoMs;
+};
+
+#endif // SEARCH_H
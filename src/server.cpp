@@ -0,0 +1,240 @@
+#include "server.h"
+#include "uci.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+#include <thread>
+
+#ifndef _WIN32
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifndef _WIN32
+    // Buffered reads from a connected socket. The session reads commands
+    // while pool workers write replies, so each direction gets its own
+    // buffer and stream and they share no state but the descriptor.
+    class SocketReadBuf : public std::streambuf {
+    public:
+        explicit SocketReadBuf(int fd) : _fd(fd) {
+            setg(_buffer, _buffer, _buffer);
+        }
+
+    protected:
+        int_type underflow() override {
+            ssize_t received;
+            do {
+                received = ::recv(_fd, _buffer, sizeof(_buffer), 0);
+            } while (received < 0 && errno == EINTR);
+            if (received <= 0) {
+                return traits_type::eof();
+            }
+            setg(_buffer, _buffer, _buffer + received);
+            return traits_type::to_int_type(_buffer[0]);
+        }
+
+    private:
+        int _fd;
+        char _buffer[4096];
+    };
+
+    // Buffered writes to a connected socket, flushed by the UCI writer
+    class SocketWriteBuf : public std::streambuf {
+    public:
+        explicit SocketWriteBuf(int fd) : _fd(fd) {
+            setp(_buffer, _buffer + sizeof(_buffer));
+        }
+
+    protected:
+        int_type overflow(int_type c) override {
+            if (sync() != 0) {
+                return traits_type::eof();
+            }
+            if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+        int sync() override {
+            // A client that went away must not kill the server with SIGPIPE
+            const char* data = pbase();
+            while (data < pptr()) {
+                ssize_t sent = ::send(_fd, data, static_cast<size_t>(pptr() - data), MSG_NOSIGNAL);
+                if (sent < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (sent <= 0) {
+                    setp(_buffer, _buffer + sizeof(_buffer));
+                    return -1;
+                }
+                data += sent;
+            }
+            setp(_buffer, _buffer + sizeof(_buffer));
+            return 0;
+        }
+
+    private:
+        int _fd;
+        char _buffer[4096];
+    };
+#endif
+}
+
+Server::Server(size_t searchThreads) : _pool(searchThreads), _listenFd(-1), _stopping(false) {
+}
+
+Server::~Server() {
+    stop();
+
+    // Sessions use the pool and the server, wait for them to end
+    std::unique_lock<std::mutex> lock(_sessionsMutex);
+    _sessionEnded.wait(lock, [this]() { return _sessions.empty(); });
+    lock.unlock();
+
+#ifndef _WIN32
+    if (_listenFd >= 0) {
+        ::close(_listenFd);
+    }
+    if (!_socketPath.empty()) {
+        ::unlink(_socketPath.c_str());
+    }
+#endif
+}
+
+bool Server::listen(const std::string& address) {
+#ifdef _WIN32
+    std::cerr << "Server mode is not supported on this platform" << std::endl;
+    return false;
+#else
+    std::string path;
+    if (address.compare(0, 5, "unix:") == 0) {
+        path = address.substr(5);
+    } else if (address.find('/') != std::string::npos) {
+        path = address;
+    }
+
+    if (!path.empty()) {
+        sockaddr_un local{};
+        if (path.size() >= sizeof(local.sun_path)) {
+            std::cerr << "Socket path too long: " << path << std::endl;
+            return false;
+        }
+        local.sun_family = AF_UNIX;
+        std::strncpy(local.sun_path, path.c_str(), sizeof(local.sun_path) - 1);
+
+        // A socket file left by a server that didn't shut down cleanly would block the bind
+        ::unlink(path.c_str());
+        _listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (_listenFd < 0 || ::bind(_listenFd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            std::cerr << "Could not bind " << path << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        _socketPath = path;
+    } else {
+        // TCP is only served on the loopback interface
+        std::string port = address;
+        for (const char* host : {"localhost:", "127.0.0.1:"}) {
+            if (port.compare(0, std::strlen(host), host) == 0) {
+                port = port.substr(std::strlen(host));
+            }
+        }
+        char* end = nullptr;
+        long number = std::strtol(port.c_str(), &end, 10);
+        if (port.empty() || *end != '\0' || number <= 0 || number > 65535) {
+            std::cerr << "Invalid address " << address << std::endl;
+            return false;
+        }
+
+        sockaddr_in local{};
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        local.sin_port = htons(static_cast<uint16_t>(number));
+
+        _listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        if (_listenFd < 0 || ::setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+            ::bind(_listenFd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+            std::cerr << "Could not bind port " << number << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+
+    if (::listen(_listenFd, SOMAXCONN) != 0) {
+        std::cerr << "Could not listen on " << address << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+#endif
+}
+
+void Server::run() {
+#ifndef _WIN32
+    while (!_stopping && _listenFd >= 0) {
+        // Wake up regularly to notice a stop request
+        pollfd listening{_listenFd, POLLIN, 0};
+        int ready = ::poll(&listening, 1, SERVER_POLL_INTERVAL_MS);
+        if (ready <= 0) {
+            continue;
+        }
+
+        int fd = ::accept(_listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_sessionsMutex);
+            _sessions.insert(fd);
+            if (_stopping) {
+                ::shutdown(fd, SHUT_RDWR);
+            }
+        }
+        std::thread(&Server::serveSession, this, fd).detach();
+    }
+#endif
+}
+
+void Server::stop() {
+    _stopping = true;
+
+#ifndef _WIN32
+    // Closing the input ends the session loops
+    std::lock_guard<std::mutex> lock(_sessionsMutex);
+    for (int fd : _sessions) {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+#endif
+}
+
+size_t Server::sessionCount() const {
+    std::lock_guard<std::mutex> lock(_sessionsMutex);
+    return _sessions.size();
+}
+
+void Server::serveSession(int fd) {
+#ifndef _WIN32
+    {
+        SocketReadBuf inBuffer(fd);
+        SocketWriteBuf outBuffer(fd);
+        std::istream in(&inBuffer);
+        std::ostream out(&outBuffer);
+        UCI uci(in, out, &_pool);
+        uci.startLoop();
+    }
+
+    std::lock_guard<std::mutex> lock(_sessionsMutex);
+    _sessions.erase(fd);
+    ::close(fd);
+    _sessionEnded.notify_all();
+#else
+    (void)fd;
+#endif
+}
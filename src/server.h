@@ -0,0 +1,62 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "thread_pool.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <set>
+#include <string>
+
+// Time between checks for a stop request while waiting for connections
+constexpr int SERVER_POLL_INTERVAL_MS = 100;
+
+// Serves UCI sessions to many clients from one process. Each connection is a
+// session with its own engine state (position, options, hash table); the value
+// network, bitbases and memory-mapped books are shared by all of them, and their
+// searches run on one pool of worker threads. The bitbases must be loaded before
+// run, sessions can't change them.
+class Server {
+public:
+    // Server running at most searchThreads searches at a time
+    explicit Server(size_t searchThreads);
+
+    // Stops the server and waits for the sessions to end
+    ~Server();
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    // Listen on a Unix domain socket ("unix:<path>", or any address containing a '/')
+    // or on a localhost TCP port ("<port>" or "localhost:<port>"); false if it can't
+    bool listen(const std::string& address);
+
+    // Accept connections and serve each on its own session thread until stopped
+    void run();
+
+    // Stop accepting connections and close the open sessions (thread-safe)
+    void stop();
+
+    // Number of sessions currently connected
+    size_t sessionCount() const;
+
+private:
+    // Run the UCI loop of one connection
+    void serveSession(int fd);
+
+    ThreadPool _pool;
+    int _listenFd;
+
+    // Path of the Unix domain socket, removed when the server closes
+    std::string _socketPath;
+
+    std::atomic<bool> _stopping;
+
+    // Connected sockets, closed on stop so their sessions end
+    mutable std::mutex _sessionsMutex;
+    std::condition_variable _sessionEnded;
+    std::set<int> _sessions;
+};
+
+#endif // SERVER_H
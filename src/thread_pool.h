@@ -0,0 +1,42 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads running submitted tasks in submission order
+class ThreadPool {
+public:
+    // Start the workers (at least one)
+    explicit ThreadPool(size_t threads);
+
+    // Finish the queued tasks and join the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a task, returning a future that is ready once it has run (thread-safe)
+    std::future<void> submit(std::function<void()> task);
+
+    // Number of worker threads
+    size_t size() const { return _workers.size(); }
+
+private:
+    // Worker loop: run queued tasks until the pool is destroyed
+    void run();
+
+    std::vector<std::thread> _workers;
+    std::deque<std::packaged_task<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _queued;
+    bool _stopping;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,81 @@
+#include "timeman.h"
+#include "search.h"
+#include <algorithm>
+
+namespace {
+    // Moves left to plan for when the time control doesn't say
+    const int DEFAULT_MOVES_TO_GO = 30;
+    
+    // Never plan for more moves than this, even if the time control says so
+    const int MAX_MOVES_TO_GO = 50;
+    
+    // The hard limit may exceed the soft limit by this factor
+    const int HARD_LIMIT_FACTOR = 4;
+}
+
+TimeManager::TimeManager() : _timed(false), _softLimit(0), _hardLimit(0), _moveOverhead(30) {
+    _startTime = std::chrono::steady_clock::now();
+}
+
+void TimeManager::start(const SearchLimits& limits, Color us) {
+    _startTime = std::chrono::steady_clock::now();
+    _timed = false;
+    _softLimit = 0;
+    _hardLimit = 0;
+    
+    if (limits.infinite) {
+        return;
+    }
+    
+    // Fixed time per move
+    if (limits.moveTime > 0) {
+        _timed = true;
+        _softLimit = _hardLimit = std::max<int64_t>(1, limits.moveTime - _moveOverhead);
+        return;
+    }
+    
+    int64_t time = limits.time[us];
+    if (time <= 0) {
+        return;
+    }
+    
+    _timed = true;
+    
+    // Time we can spend without risking the clock
+    int64_t available = std::max<int64_t>(1, time - _moveOverhead);
+    
+    // Spread the remaining time over the expected number of moves, and
+    // spend most of the increment since it comes back after the move
+    int movesToGo = limits.movesToGo > 0 ? std::min(limits.movesToGo, MAX_MOVES_TO_GO) : DEFAULT_MOVES_TO_GO;
+    int64_t optimum = available / movesToGo + limits.increment[us] * 3 / 4;
+    
+    // Never plan to use more than most of what is left on the clock
+    int64_t maximum = available * 4 / 5;
+    
+    _hardLimit = std::max<int64_t>(1, std::min(optimum * HARD_LIMIT_FACTOR, maximum));
+    _softLimit = std::max<int64_t>(1, std::min(optimum, _hardLimit));
+}
+
+int64_t TimeManager::elapsed() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - _startTime).count();
+}
+
+bool TimeManager::canStartIteration(int64_t lastIterationMs, double branchingFactor) const {
+    if (!_timed) {
+        return true;
+    }
+    
+    int64_t now = elapsed();
+    if (now >= _softLimit) {
+        return false;
+    }
+    
+    // Predict the duration of the next iteration from the last one
+    double factor = std::max(branchingFactor, 2.0);
+    return now + static_cast<int64_t>(lastIterationMs * factor) <= _hardLimit;
+}
+
+bool TimeManager::hardLimitReached() const {
+    return _timed && elapsed() >= _hardLimit;
+}
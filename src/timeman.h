@@ -0,0 +1,59 @@
+#ifndef TIMEMAN_H
+#define TIMEMAN_H
+
+#include "bitboard.h"
+#include <chrono>
+#include <cstdint>
+
+struct SearchLimits;
+
+// Allocates thinking time for a move from the UCI clock parameters
+class TimeManager {
+public:
+    // Constructor
+    TimeManager();
+    
+    // Start the clock and compute the limits for this move
+    void start(const SearchLimits& limits, Color us);
+    
+    // Check if the search is limited by time at all
+    bool isTimed() const { return _timed; }
+    
+    // Milliseconds elapsed since the search started
+    int64_t elapsed() const;
+    
+    // Time after which no new iteration should be started
+    int64_t softLimit() const { return _softLimit; }
+    
+    // Time after which the search must stop immediately
+    int64_t hardLimit() const { return _hardLimit; }
+    
+    // Check if the next iteration is expected to finish within the limits,
+    // given the duration of the last one and the branching factor
+    bool canStartIteration(int64_t lastIterationMs, double branchingFactor) const;
+    
+    // Check if the hard limit has been reached
+    bool hardLimitReached() const;
+    
+    // Set the time reserved for communication delays per move
+    void setMoveOverhead(int64_t overheadMs) { _moveOverhead = overheadMs; }
+    
+    // Get the time reserved for communication delays per move
+    int64_t moveOverhead() const { return _moveOverhead; }
+
+private:
+    // Time the search started
+    std::chrono::steady_clock::time_point _startTime;
+    
+    // Whether time limits apply
+    bool _timed;
+    
+    // Computed limits in milliseconds
+    int64_t _softLimit;
+    int64_t _hardLimit;
+    
+    // Time reserved for communication delays per move in milliseconds
+    int64_t _moveOverhead;
+};
+
+#endif // TIMEMAN_H
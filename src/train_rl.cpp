@@ -10,8 +10,11 @@
 #include <future>
 #include <atomic>
 #include <numeric>
+#include <functional>
 #include <climits>
 #include "chess_rl.h"
+#include "book.h"
+#include "bitbase.h"
 
 // Configuration parameters
 const int NUM_GENERATIONS = 100;         // Number of generations to run
@@ -21,6 +24,8 @@ const int ELITES_TO_KEEP = 2;            // Top agents to preserve unchanged
 const int TRAINING_EPISODES_PER_GEN = 50; // Self-play episodes per agent per generation
 const int MAX_MOVES_PER_GAME = 200;      // Maximum moves per game
 const float MUTATION_RATE = 0.05f;       // Rate of mutation for new generations
+const int BASELINE_GAMES = 4;            // Games of the best agent against the handcrafted evaluation
+const int MAX_BOOK_PLIES = 12;           // Opening book plies played before a self-play game starts
 
 // Multithreading parameters
 const int MAX_THREADS = std::thread::hardware_concurrency(); // Use all available cores
@@ -97,20 +102,59 @@ struct MatchupResult {
 	float score;
 };
 
+// Opening book for varied self-play start positions (used when book.bin is present)
+Book openingBook;
+
+// Play a random line from the opening book, weighted by the book's move weights
+void playBookOpening(Board& board) {
+	if (!openingBook.isOpen()) {
+		return;
+	}
+
+	thread_local std::mt19937 rng(std::random_device{}());
+	for (int ply = 0; ply < MAX_BOOK_PLIES; ply++) {
+		Move move = openingBook.probe(board, rng);
+		if (!move.isValid()) {
+			break;
+		}
+		board.makeMove(move);
+	}
+}
+
+// Check if the endgame bitbases decide a position, with the result from White's point of view
+bool adjudicateEnding(const Board& board, float& whiteScore) {
+	Bitbases::WDL wdl;
+	if (!Bitbases::probe(board, wdl)) {
+		return false;
+	}
+	int whiteResult = board.sideToMove() == WHITE ? wdl : -wdl;
+	whiteScore = 0.5f + 0.5f * whiteResult;
+	return true;
+}
+
 // Function to play a single self-play episode and update stats
 void playSelfPlayEpisode(ChessRLAgent& agent, TrainingStats& stats, int episodeNum,
 	std::mutex& outputMutex) {
 	Board board;
 	board.reset();
+	playBookOpening(board);
 
 	std::vector<GameState> gameHistory;
 	int moveCount = 0;
+	bool adjudicated = false;
+	float bitbaseScore = 0.5f;
 
 	// Play the game
 	while (!board.isCheckmate() && !board.isStalemate() &&
 		!board.isInsufficientMaterial() && board.halfmoveClock() < 100 &&
 		moveCount < MAX_MOVES_PER_GAME) {
 
+		// Stop once the bitbases know the result
+		if (adjudicateEnding(board, bitbaseScore)) {
+			adjudicated = true;
+			break;
+		}
+
 		std::vector<Move> legalMoves = board.generateLegalMoves();
 		if (legalMoves.empty()) break;
 
@@ -146,6 +190,14 @@ void playSelfPlayEpisode(ChessRLAgent& agent, TrainingStats& stats, int episodeN
 		finalReward = 0.0f;
 		isDraw = true;
 	}
+	else if (adjudicated) {
+		// Like a checkmate, rewarded from the point of view of the side that moved last
+		float lastMoverScore = board.sideToMove() == BLACK ? bitbaseScore : 1.0f - bitbaseScore;
+		finalReward = 2.0f * lastMoverScore - 1.0f;
+		isWhiteWin = bitbaseScore > 0.5f;
+		isBlackWin = bitbaseScore < 0.5f;
+		isDraw = bitbaseScore == 0.5f;
+	}
 	else {
 		finalReward = materialBalance / 100.0f;
 		isTruncated = true;
@@ -172,6 +224,9 @@ void playSelfPlayEpisode(ChessRLAgent& agent, TrainingStats& stats, int episodeN
 		else if (board.halfmoveClock() >= 100) {
 			std::cout << "50-move rule";
 		}
+		else if (adjudicated) {
+			std::cout << "Bitbase " << (isDraw ? "draw" : isWhiteWin ? "win (White)" : "win (Black)");
+		}
 		else {
 			std::cout << "Truncated (balance: " << std::fixed << std::setprecision(2)
 				<< materialBalance << ")";
@@ -226,27 +281,36 @@ TrainingStatsResult trainAgentViaSelfPlay(ChessRLAgent& agent, int episodes) {
 	return stats.getResults();
 }
 
-// Function to play a game between two agents (thread-safe)
-float playGame(ChessRLAgent& whiteAgent, ChessRLAgent& blackAgent) {
+// Function type for picking a move in a game
+using MoveChooser = std::function<Move(const Board&, const std::vector<Move>&)>;
+
+// Function to play a game between two players, the adjudicator scores unfinished games
+float playGame(const MoveChooser& whitePlayer, const MoveChooser& blackPlayer, ChessRLAgent& adjudicator) {
 	Board board;
 	board.reset();
 
 	int moveCount = 0;
+	float bitbaseScore;
 
 	// Play the game
 	while (!board.isCheckmate() && !board.isStalemate() &&
 		!board.isInsufficientMaterial() && board.halfmoveClock() < 100 &&
 		moveCount < MAX_MOVES_PER_GAME) {
 
+		// Endings the bitbases know are decided on the spot
+		if (adjudicateEnding(board, bitbaseScore)) {
+			return bitbaseScore;
+		}
+
 		std::vector<Move> legalMoves = board.generateLegalMoves();
 		if (legalMoves.empty()) break;
 
 		Move selectedMove;
 		if (board.sideToMove() == WHITE) {
-			selectedMove = whiteAgent.selectMove(board, legalMoves);
+			selectedMove = whitePlayer(board, legalMoves);
 		}
 		else {
-			selectedMove = blackAgent.selectMove(board, legalMoves);
+			selectedMove = blackPlayer(board, legalMoves);
 		}
 
 		board.makeMove(selectedMove);
@@ -264,7 +328,7 @@ float playGame(ChessRLAgent& whiteAgent, ChessRLAgent& blackAgent) {
 	}
 	else {
 		// Evaluate final position based on material balance
-		float materialBalance = whiteAgent.calculateReward(board, WHITE) * 100.0f;
+		float materialBalance = adjudicator.calculateReward(board, WHITE) * 100.0f;
 		if (materialBalance > 0.5f) {
 			result = 0.6f; // Slight advantage to white
 		}
@@ -279,6 +343,37 @@ float playGame(ChessRLAgent& whiteAgent, ChessRLAgent& blackAgent) {
 	return result; // Return the result from white's perspective
 }
 
+// Function to play a game between two agents (thread-safe)
+float playGame(ChessRLAgent& whiteAgent, ChessRLAgent& blackAgent) {
+	return playGame(
+		[&whiteAgent](const Board& board, const std::vector<Move>& moves) { return whiteAgent.selectMove(board, moves); },
+		[&blackAgent](const Board& board, const std::vector<Move>& moves) { return blackAgent.selectMove(board, moves); },
+		whiteAgent);
+}
+
+// Function to measure an agent against the handcrafted evaluation, returns its average score
+float playBaselineGames(ChessRLAgent& agent, int games) {
+	MoveChooser agentPlayer = [&agent](const Board& board, const std::vector<Move>& moves) {
+		return agent.selectMove(board, moves);
+	};
+	MoveChooser baselinePlayer = [](const Board& board, const std::vector<Move>& moves) {
+		return staticEvalMove(moves, board);
+	};
+
+	float totalScore = 0.0f;
+	for (int game = 0; game < games; game++) {
+		// Alternate who plays white
+		if (game % 2 == 0) {
+			totalScore += playGame(agentPlayer, baselinePlayer, agent);
+		}
+		else {
+			totalScore += 1.0f - playGame(baselinePlayer, agentPlayer, agent);
+		}
+	}
+
+	return games > 0 ? totalScore / games : 0.0f;
+}
+
 // Function to play a matchup between two agents (multithreaded worker)
 MatchupResult playMatchup(std::vector<std::unique_ptr<ChessRLAgent>>& agents,
 	size_t agent1Idx, size_t agent2Idx) {
@@ -429,6 +524,15 @@ int main() {
 
 	std::cout << "Starting Chess RL Tournament Training with " << MAX_THREADS << " threads" << std::endl;
 
+	if (openingBook.open(DEFAULT_BOOK_FILE)) {
+		std::cout << "Self-play games start from " << DEFAULT_BOOK_FILE << " (" << openingBook.size() << " entries)" << std::endl;
+	}
+
+	int bitbases = Bitbases::load(DEFAULT_BITBASE_DIRECTORY);
+	if (bitbases > 0) {
+		std::cout << "Games are adjudicated with " << bitbases << " endgame bitbases" << std::endl;
+	}
+
 	// Initialize population
 	std::vector<std::unique_ptr<ChessRLAgent>> population;
 
@@ -489,7 +593,10 @@ int main() {
 				<< stats.whiteWins << "W/" << stats.blackWins << "B/"
 				<< stats.draws << "D/" << stats.truncated << "T, "
 				<< "Avg moves: " << (stats.totalGames > 0 ? static_cast<float>(stats.totalMoves) / stats.totalGames : 0)
+				<< ", Eval cache hit rate: " << std::fixed << std::setprecision(1)
+				<< population[i]->evaluationCache().hitRate() * 100.0 << "%"
 				<< std::endl;
+			population[i]->evaluationCache().resetStats();
 		}
 
 		// Run tournament
@@ -510,6 +617,11 @@ int main() {
 		size_t bestAgentIdx = results.rankings[0];
 		float bestScore = results.totalScores[bestAgentIdx];
 
+		// Measure progress against a fixed opponent
+		float baselineScore = playBaselineGames(*population[bestAgentIdx], BASELINE_GAMES);
+		std::cout << "Best agent vs handcrafted evaluation: " << std::fixed << std::setprecision(2)
+			<< baselineScore * 100 << "%" << std::endl;
+
 		bestScores.push_back(bestScore);
 		bestAgents.push_back(bestAgentIdx);
 
@@ -551,12 +663,13 @@ int main() {
 		while (nextGeneration.size() + childFutures.size() < POPULATION_SIZE) {
 			// Select parents from top half
 			std::uniform_int_distribution<size_t> parentDist(0, POPULATION_SIZE / 2);
-			size_t parent1Rank = parentDist(std::mt19937(std::random_device()()));
-			size_t parent2Rank = parentDist(std::mt19937(std::random_device()()));
+			std::mt19937 parentRng(std::random_device{}());
+			size_t parent1Rank = parentDist(parentRng);
+			size_t parent2Rank = parentDist(parentRng);
 
 			// Ensure we don't use the same parent twice
 			while (parent2Rank == parent1Rank) {
-				parent2Rank = parentDist(std::mt19937(std::random_device()()));
+				parent2Rank = parentDist(parentRng);
 			}
 
 			size_t parent1Idx = results.rankings[parent1Rank];
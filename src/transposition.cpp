@@ -0,0 +1,73 @@
+#include "transposition.h"
+#include <algorithm>
+
+TranspositionTable::TranspositionTable(size_t sizeMb) : _mask(0), _sizeMb(0), _generation(0) {
+    resize(sizeMb);
+}
+
+void TranspositionTable::resize(size_t sizeMb) {
+    if (sizeMb == 0) {
+        sizeMb = 1;
+    }
+    
+    // Round the number of entries down to a power of two
+    size_t maxEntries = sizeMb * 1024 * 1024 / sizeof(TTEntry);
+    size_t numEntries = 1;
+    while (numEntries * 2 <= maxEntries) {
+        numEntries *= 2;
+    }
+    
+    _entries.assign(numEntries, TTEntry{});
+    _mask = numEntries - 1;
+    _sizeMb = sizeMb;
+    _generation = 0;
+}
+
+void TranspositionTable::clear() {
+    std::fill(_entries.begin(), _entries.end(), TTEntry{});
+    _generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    _generation = (_generation + 1) & 0x3F;
+}
+
+const TTEntry* TranspositionTable::probe(HashKey key) const {
+    const TTEntry& entry = _entries[key & _mask];
+    if (entry.key == key && entry.bound() != BOUND_NONE) {
+        return &entry;
+    }
+    return nullptr;
+}
+
+void TranspositionTable::store(HashKey key, Move move, int score, int staticEval, int depth, BoundType bound) {
+    TTEntry& entry = _entries[key & _mask];
+    
+    // Keep deeper results from the current search for other positions
+    if (entry.key != key && entry.generation() == _generation &&
+        entry.bound() != BOUND_NONE && entry.depth > depth + 2) {
+        return;
+    }
+    
+    // Keep the old best move if this result doesn't have one
+    if (move.isValid() || entry.key != key) {
+        entry.move = move.pack();
+    }
+    
+    entry.key = key;
+    entry.score = static_cast<int16_t>(score);
+    entry.staticEval = static_cast<int16_t>(staticEval);
+    entry.depth = static_cast<int8_t>(depth);
+    entry.boundAndGeneration = static_cast<uint8_t>(bound | (_generation << 2));
+}
+
+int TranspositionTable::hashfull() const {
+    size_t sample = std::min<size_t>(1000, _entries.size());
+    int used = 0;
+    for (size_t i = 0; i < sample; ++i) {
+        if (_entries[i].bound() != BOUND_NONE && _entries[i].generation() == _generation) {
+            used++;
+        }
+    }
+    return static_cast<int>(used * 1000 / sample);
+}
@@ -0,0 +1,70 @@
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include "board.h"
+#include <vector>
+#include <cstddef>
+
+// Type of bound stored with a transposition table score
+enum BoundType : uint8_t {
+    BOUND_NONE = 0,
+    BOUND_UPPER = 1,     // Score is at most the stored value (fail low)
+    BOUND_LOWER = 2,     // Score is at least the stored value (fail high)
+    BOUND_EXACT = 3      // Score is exact (PV node)
+};
+
+// A single transposition table entry (16 bytes)
+struct TTEntry {
+    HashKey key;
+    uint16_t move;
+    int16_t score;
+    int16_t staticEval;
+    int8_t depth;
+    uint8_t boundAndGeneration;
+
+    BoundType bound() const { return static_cast<BoundType>(boundAndGeneration & 0x3); }
+    uint8_t generation() const { return boundAndGeneration >> 2; }
+};
+
+// Hash table of previously searched positions
+class TranspositionTable {
+public:
+    // Constructor
+    explicit TranspositionTable(size_t sizeMb = 16);
+    
+    // Resize the table (clears all entries)
+    void resize(size_t sizeMb);
+    
+    // Clear all entries
+    void clear();
+    
+    // Start a new search so older entries are preferred for replacement
+    void newSearch();
+    
+    // Look up a position, returns nullptr if not found
+    const TTEntry* probe(HashKey key) const;
+    
+    // Store a search result for a position
+    void store(HashKey key, Move move, int score, int staticEval, int depth, BoundType bound);
+    
+    // Permill of the table used by the current search (for UCI hashfull)
+    int hashfull() const;
+    
+    // Get the table size in megabytes
+    size_t sizeMb() const { return _sizeMb; }
+
+private:
+    // Entries of the table
+    std::vector<TTEntry> _entries;
+    
+    // Index mask (table size is a power of two)
+    size_t _mask;
+    
+    // Requested size in megabytes
+    size_t _sizeMb;
+    
+    // Current search generation (6 bits)
+    uint8_t _generation;
+};
+
+#endif // TRANSPOSITION_H
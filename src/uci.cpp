@@ -1,83 +1,133 @@
 #include "uci.h"
 #include <iostream>
-#include <sstream>
 #include <thread>
 #include <chrono>
+#include <algorithm>
 
-UCI::UCI() : _quit(false) {
+UCI::UCI(std::istream& in, std::ostream& out, ThreadPool* pool)
+    : _quit(false), _in(in), _pool(pool), _output(out) {
     // Initialize board to starting position
     _board.reset();
     
     // Set the engine's position to match
     _engine.setPosition(_board);
+    
+    // Report search progress to the GUI
+    _engine.setInfoCallback([this](const SearchInfo& info) { sendInfo(info); });
+}
+
+UCI::~UCI() {
+    stopSearch();
 }
 
 void UCI::startLoop() {
     std::string line;
     
-    while (!_quit && std::getline(std::cin, line)) {
+    while (!_quit && std::getline(_in, line)) {
         processCommand(line);
     }
+    
+    // Input closed or quit received
+    stopSearch();
 }
 
-void UCI::processCommand(const std::string& command) {
-    std::istringstream is(command);
-    std::string token;
-    
-    is >> token;
+void UCI::processCommand(std::string_view command) {
+    UciTokenizer tokens(command);
+    std::string_view token = tokens.next();
     
+    // Commands that change the engine state must not race with a running search
     if (token == "uci") {
         handleUci();
     } else if (token == "setoption") {
-        handleSetOption(is);
+        stopSearch();
+        handleSetOption(tokens);
     } else if (token == "isready") {
         handleIsReady();
     } else if (token == "position") {
-        handlePosition(is);
+        stopSearch();
+        handlePosition(tokens);
     } else if (token == "go") {
-        handleGo(is);
+        stopSearch();
+        handleGo(tokens);
     } else if (token == "stop") {
         handleStop();
+    } else if (token == "ponderhit") {
+        handlePonderhit();
     } else if (token == "quit") {
         handleQuit();
     } else if (token == "ucinewgame") {
+        stopSearch();
         handleUciNewGame();
     } else if (token == "printboard") {
         handlePrintBoard();
+    } else if (token == "bench") {
+        stopSearch();
+        handleBench(tokens);
     }
 }
 
 void UCI::handleUci() {
-    sendResponse("id name BitChess RL");
-    sendResponse("id author AndreasKoumoundouros");
+    // The whole option list goes out with one flush
+    std::lock_guard<std::mutex> lock(_outputMutex);
+    
+    _output << "id name BitChess RL\n";
+    _output << "id author AndreasKoumoundouros\n";
     
     // Send UCI options here if needed
-    // sendResponse("option name Hash type spin default 64 min 1 max 1024");
-    sendResponse("option name UCI_Chess960 type check default false");
+    _output << "option name Hash type spin default 16 min 1 max 1024\n";
+    _output << "option name MultiPV type spin default 1 min 1 max " << MAX_MULTI_PV << '\n';
+    _output << "option name MoveOverhead type spin default 30 min 0 max 5000\n";
+    _output << "option name Ponder type check default false\n";
+    _output << "option name UCI_Chess960 type check default false\n";
+    _output << "option name OwnBook type check default false\n";
+    _output << "option name BookFile type string default " << DEFAULT_BOOK_FILE << '\n';
+    if (!_pool) {
+        _output << "option name BitbasePath type string default " << DEFAULT_BITBASE_DIRECTORY << '\n';
+    }
+    
+    // Selective search toggles, mainly for testing their effect
+    _output << "option name NullMove type check default true\n";
+    _output << "option name LateMoveReductions type check default true\n";
+    _output << "option name FutilityPruning type check default true\n";
+    _output << "option name CheckExtensions type check default true\n";
+    
+    // Monte Carlo tree search
+    _output << "option name Threads type spin default 1 min 1 max 256\n";
+    _output << "option name MCTSVisits type spin default " << DEFAULT_MCTS_VISITS << " min 1 max 100000000\n";
+    _output << "option name MCTSHash type spin default " << DEFAULT_MCTS_HASH_MB << " min 1 max 65536\n";
 
 #ifdef ENABLE_RL
-    sendResponse("option name UseRL type check default true");
+    _output << "option name UseRL type check default true\n";
+    _output << "option name NNBatchSize type spin default 1 min 1 max 256\n";
+    _output << "option name NNBatchLatency type spin default " << DEFAULT_EVAL_BATCH_LATENCY_US << " min 0 max 1000000\n";
+    _output << "option name Strategy type combo default Model var Model var AlphaBeta var MCTS\n";
+#else
+    _output << "option name Strategy type combo default AlphaBeta var AlphaBeta var MCTS\n";
 #endif
     
-    sendResponse("uciok");
+    _output << "uciok\n";
+    _output.flush();
 }
 
-void UCI::handleSetOption(std::istringstream& is) {
-    std::string name, id;
-
-    is >> name >> id;
+void UCI::handleSetOption(UciTokenizer& tokens) {
+    std::string_view name = tokens.next();
+    std::string_view id = tokens.next();
 
     // Validating setoption command
     if (name != "name") {
         return;
     }
 
-    std::cout << "Handling: " << id << "\n";
+    {
+        std::lock_guard<std::mutex> lock(_outputMutex);
+        _output << "Handling: " << id << '\n';
+        _output.flush();
+    }
 
     if (id == "UCI_Chess960") {
         // Handle Chess960 mode
-        std::string value, data;
-        is >> value >> data;
+        std::string_view value = tokens.next();
+        std::string_view data = tokens.next();
         if (value != "value") {
             return;
         }
@@ -90,16 +140,157 @@ void UCI::handleSetOption(std::istringstream& is) {
             _board._chess960 = true;
         }
     }
+    if (id == "Hash") {
+        size_t sizeMb;
+        if (tokens.next() != "value" || !tokens.next(sizeMb)) {
+            return;
+        }
+        
+        _engine.search().setHashSize(sizeMb);
+    }
+    if (id == "MCTSHash") {
+        size_t sizeMb;
+        if (tokens.next() != "value" || !tokens.next(sizeMb) || sizeMb < 1) {
+            return;
+        }
+        
+        _engine.mcts().setHashSize(sizeMb);
+    }
+    if (id == "MultiPV") {
+        int lines;
+        if (tokens.next() != "value" || !tokens.next(lines)) {
+            return;
+        }
+        
+        _engine.search().setMultiPv(std::min(lines, MAX_MULTI_PV));
+    }
+    if (id == "MoveOverhead") {
+        int64_t overheadMs;
+        if (tokens.next() != "value" || !tokens.next(overheadMs)) {
+            return;
+        }
+        
+        _engine.setMoveOverhead(overheadMs);
+    }
+    if (id == "OwnBook") {
+        std::string_view value = tokens.next();
+        std::string_view data = tokens.next();
+        if (value != "value") {
+            return;
+        }
+        
+        _engine.setOwnBook(data == "true");
+        if (_engine.ownBook() && !_engine.book().isOpen()) {
+            openBook();
+        }
+    }
+    if (id == "BookFile") {
+        if (tokens.next() != "value") {
+            return;
+        }
+        
+        // The path may contain spaces
+        _bookFile = std::string(tokens.rest());
+        if (_engine.ownBook()) {
+            openBook();
+        } else {
+            _engine.book().close();
+        }
+    }
+    if (id == "BitbasePath") {
+        if (tokens.next() != "value") {
+            return;
+        }
+        
+        // The tables belong to the whole process: sessions sharing a pool may be
+        // searching them, so only a session of its own can replace them
+        if (_pool) {
+            sendResponse("info string BitbasePath is shared by all sessions and can't be changed");
+            return;
+        }
+        
+        // The path may contain spaces
+        std::string path(tokens.rest());
+        Bitbases::clear();
+        if (Bitbases::load(path) == 0) {
+            sendResponse("info string No bitbases found in " + path);
+        }
+    }
+    if (id == "NullMove" || id == "LateMoveReductions" || id == "FutilityPruning" || id == "CheckExtensions") {
+        std::string_view value = tokens.next();
+        std::string_view data = tokens.next();
+        if (value != "value") {
+            return;
+        }
+        
+        bool enabled = (data == "true");
+        SearchOptions& options = _engine.search().options();
+        if (id == "NullMove") {
+            options.nullMove = enabled;
+        } else if (id == "LateMoveReductions") {
+            options.lateMoveReductions = enabled;
+        } else if (id == "FutilityPruning") {
+            options.futilityPruning = enabled;
+        } else {
+            options.checkExtensions = enabled;
+        }
+    }
+    if (id == "Threads" || id == "MCTSVisits") {
+        int64_t number;
+        if (tokens.next() != "value" || !tokens.next(number) || number < 1) {
+            return;
+        }
+        
+        MCTSOptions& options = _engine.mcts().options();
+        if (id == "Threads") {
+            options.threads = static_cast<int>(number);
+        } else {
+            options.visits = static_cast<uint64_t>(number);
+        }
+    }
+#ifdef ENABLE_RL
+    if (id == "NNBatchSize" || id == "NNBatchLatency") {
+        int64_t number;
+        if (tokens.next() != "value" || !tokens.next(number) || number < 0) {
+            return;
+        }
+        
+        if (id == "NNBatchSize") {
+            _evalBatchSize = static_cast<size_t>(std::max<int64_t>(number, 1));
+        } else {
+            _evalBatchLatencyUs = number;
+        }
+        _engine.setEvalBatching(_evalBatchSize, _evalBatchLatencyUs);
+    }
+#endif
+    if (id == "Strategy") {
+        std::string_view value = tokens.next();
+        std::string_view data = tokens.next();
+        if (value != "value") {
+            return;
+        }
+        
+        if (data == "AlphaBeta") {
+            _engine.setStrategy(EngineStrategy::AlphaBeta);
+        } else if (data == "MCTS") {
+            _engine.setStrategy(EngineStrategy::MonteCarlo);
+        }
+#ifdef ENABLE_RL
+        else if (data == "Model") {
+            _engine.setMoveSelectionStrategy(std::bind(&modelBasedMove, std::placeholders::_1, std::placeholders::_2));
+        }
+#endif
+    }
 #ifdef ENABLE_RL
     if (id == "UseRL") {
-		std::string value, data;
-		is >> value >> data;
+		std::string_view value = tokens.next();
+		std::string_view data = tokens.next();
 		if (value != "value") {
 			return;
 		}
 
 		if (data == "false") {
-            _engine.setMoveSelectionStrategy(std::bind(&Engine::weightedRandomMove, std::placeholders::_1, std::placeholders::_2));
+            _engine.useSearch();
 		}
 		else if (data == "true")
 		{
@@ -109,108 +300,295 @@ void UCI::handleSetOption(std::istringstream& is) {
 #endif
 }
 
+void UCI::openBook() {
+    if (!_engine.book().open(_bookFile)) {
+        sendResponse("info string Could not open book " + _bookFile);
+    }
+}
+
 void UCI::handleIsReady() {
     sendResponse("readyok");
 }
 
-void UCI::handlePosition(std::istringstream& is) {
-    std::string token;
-    is >> token;
+void UCI::handlePosition(UciTokenizer& tokens) {
+    std::string_view token = tokens.next();
+    std::string_view start;
     
     if (token == "startpos") {
-        _board.reset();
-        
-        // Check for additional moves
-        is >> token;
-        if (token == "moves") {
-            std::string moves;
-            std::getline(is, moves);
-            applyMoves(moves);
-        }
+        start = token;
+        token = tokens.next();
     } else if (token == "fen") {
-        std::string fen;
-        
-        // Read the FEN string (which can contain spaces)
-        for (int i = 0; i < 6; ++i) {
-            std::string fenPart;
-            is >> fenPart;
-            fen += fenPart + (i < 5 ? " " : "");
+        // The FEN runs until the move list (it contains spaces)
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        for (token = tokens.next(); !token.empty() && token != "moves"; token = tokens.next()) {
+            begin = begin ? begin : token.data();
+            end = token.data() + token.size();
         }
-        
-        _board.setFromFen(fen);
-        
-        // Check for additional moves
-        is >> token;
-        if (token == "moves") {
-            std::string moves;
-            std::getline(is, moves);
-            applyMoves(moves);
+        if (!begin) {
+            return;
+        }
+        start = std::string_view(begin, static_cast<size_t>(end - begin));
+    } else {
+        return;
+    }
+    
+    if (token != "moves") {
+        tokens = UciTokenizer(std::string_view());
+    }
+    
+    // During a game each command repeats the previous one plus the new moves,
+    // so only those need to be played
+    bool extendsPrevious = start == _positionStart;
+    UciTokenizer previous = tokens;
+    for (size_t i = 0; extendsPrevious && i < _positionMoves.size(); ++i) {
+        std::string_view move = previous.next();
+        extendsPrevious = !move.empty() && Move::fromUci(move) == _positionMoves[i];
+    }
+    if (extendsPrevious) {
+        tokens = previous;
+    } else {
+        if (start == "startpos") {
+            _board.reset();
+        } else {
+            _board.setFromFen(std::string(start));
         }
+        _positionStart = std::string(start);
+        _positionMoves.clear();
+        _gameHistory.clear();
+    }
+    
+    for (token = tokens.next(); !token.empty(); token = tokens.next()) {
+        Move move = Move::fromUci(token);
+        Board next = _board;
+        if (!next.makeMove(move)) {
+            break;
+        }
+        _gameHistory.push_back(_board.hash());
+        _positionMoves.push_back(move);
+        _board = next;
     }
     
     // Update the engine's position
-    _engine.setPosition(_board);
+    _engine.setPosition(_board, _gameHistory);
 }
 
-void UCI::handleGo(std::istringstream& is) {
-    // For now, just make a move immediately using the random strategy
-    // In the future, this could parse time controls and use them for decision making
+void UCI::handleGo(UciTokenizer& tokens) {
+    SearchLimits limits;
+    bool limited = false;
+    
+    // Parse the search limits
+    for (std::string_view token = tokens.next(); !token.empty(); token = tokens.next()) {
+        if (token == "wtime") {
+            tokens.next(limits.time[WHITE]);
+        } else if (token == "btime") {
+            tokens.next(limits.time[BLACK]);
+        } else if (token == "winc") {
+            tokens.next(limits.increment[WHITE]);
+        } else if (token == "binc") {
+            tokens.next(limits.increment[BLACK]);
+        } else if (token == "movestogo") {
+            tokens.next(limits.movesToGo);
+        } else if (token == "movetime") {
+            tokens.next(limits.moveTime);
+        } else if (token == "depth") {
+            tokens.next(limits.depth);
+        } else if (token == "nodes") {
+            tokens.next(limits.nodes);
+        } else if (token == "mate") {
+            tokens.next(limits.mate);
+        } else if (token == "infinite") {
+            limits.infinite = true;
+        } else if (token == "ponder") {
+            limits.ponder = true;
+        } else {
+            continue;
+        }
+        limited = true;
+    }
     
-    // Make a move
-    Move move = _engine.makeMove();
+    // Without any limits, search to a fixed depth
+    if (!limited) {
+        limits.depth = DEFAULT_SEARCH_DEPTH;
+    }
     
-    // Send the move to the GUI
-    if (move.isValid()) {
-        sendResponse("bestmove " + move.toUci());
+    // Search on a separate thread so stop, isready and quit stay responsive
+    _engine.clearRequests();
+    _searchLimits = limits;
+    if (_pool) {
+        std::shared_ptr<std::atomic<bool>> claimed = std::make_shared<std::atomic<bool>>(false);
+        _searchClaimed = claimed;
+        _searchTask = _pool->submit([this, limits, claimed]() {
+            // Cancelled while queued: the session has searched and answered already
+            if (claimed->exchange(true)) {
+                return;
+            }
+            runSearch(limits);
+        });
     } else {
-        // If no valid move, just send a null move
-        sendResponse("bestmove 0000");
+        _searchThread = std::thread([this, limits]() { runSearch(limits); });
+    }
+}
+
+void UCI::runSearch(const SearchLimits& limits) {
+    Move move = _engine.makeMove(limits);
+    Move ponderMove = _engine.ponderMove();
+    
+    // In infinite and ponder mode the best move may only be sent after
+    // stop, or after ponderhit when pondering
+    std::lock_guard<std::mutex> lock(_bestMoveMutex);
+    if (!_engine.stopRequested() &&
+        (limits.infinite || (limits.ponder && !_engine.ponderhitReceived()))) {
+        _bestMovePending = true;
+        _pendingMove = move;
+        _pendingPonderMove = ponderMove;
+        return;
+    }
+    
+    // Send the move to the GUI, with the reply we expect to ponder on
+    sendBestMove(move, ponderMove);
+}
+
+void UCI::sendPendingBestMove() {
+    std::lock_guard<std::mutex> lock(_bestMoveMutex);
+    if (_bestMovePending) {
+        _bestMovePending = false;
+        sendBestMove(_pendingMove, _pendingPonderMove);
     }
 }
 
 void UCI::handleStop() {
-    // This would stop a search in progress
-    // For now, we don't have a search function, so this does nothing
+    stopSearch();
+}
+
+void UCI::handlePonderhit() {
+    // Keep the search (and everything it has learned) running, now on our clock;
+    // one that has finished already gets its move sent now
+    _engine.ponderhit();
+    sendPendingBestMove();
 }
 
 void UCI::handleQuit() {
+    stopSearch();
     _quit = true;
 }
 
+void UCI::stopSearch() {
+    if (_searchThread.joinable()) {
+        _engine.stop();
+        _searchThread.join();
+    }
+    
+    if (_searchTask.valid()) {
+        _engine.stop();
+        if (!_searchClaimed->exchange(true)) {
+            // Still queued behind other sessions' searches: rather than wait for a
+            // worker, search here, which stopped only completes its first iteration
+            _searchTask = std::future<void>();
+            runSearch(_searchLimits);
+        } else {
+            _searchTask.get();
+        }
+        _searchClaimed.reset();
+    }
+    
+    sendPendingBestMove();
+}
+
 void UCI::handleUciNewGame() {
     // Reset the board and engine for a new game
     _board.reset();
+    _positionStart.clear();
+    _positionMoves.clear();
+    _gameHistory.clear();
     _engine.setPosition(_board);
+    _engine.search().clear();
+    _engine.mcts().clear();
+    _engine.mateSolver().clear();
+}
+
+void UCI::handleBench(UciTokenizer& tokens) {
+    int depth = DEFAULT_BENCH_DEPTH;
+    if (!tokens.next(depth) || depth < 1 || depth >= MAX_PLY) {
+        depth = DEFAULT_BENCH_DEPTH;
+    }
+    
+    BenchResult total = Bench::run(depth, [this](size_t index, const std::string&, const SearchResult& result) {
+        std::lock_guard<std::mutex> lock(_outputMutex);
+        _output << "info string bench position " << index + 1 << " bestmove " << result.bestMove
+                << " nodes " << result.nodes << '\n';
+        _output.flush();
+    });
+    
+    std::lock_guard<std::mutex> lock(_outputMutex);
+    _output << "info string bench nodes " << total.nodes << " time " << total.timeMs
+            << " nps " << total.nps() << '\n';
+    _output.flush();
 }
 
 void UCI::handlePrintBoard() {
     sendResponse(_board.toString());
 }
 
-void UCI::applyMoves(const std::string& moveStr) {
-    std::istringstream iss(moveStr);
-    std::string moveToken;
+void UCI::sendResponse(std::string_view response) {
+    std::lock_guard<std::mutex> lock(_outputMutex);
+    _output << response << '\n';
+    _output.flush();
+}
+
+void UCI::sendInfo(const SearchInfo& info) {
+    uint64_t nps = info.nodes * 1000 / static_cast<uint64_t>(std::max<int64_t>(info.timeMs, 1));
     
-    while (iss >> moveToken) {
-        Move move = Move::fromUci(moveToken);
-        if (move.isValid()) {
-            _board.makeMove(move);
+    std::lock_guard<std::mutex> lock(_outputMutex);
+    _output << "info depth " << info.depth
+            << " seldepth " << info.selDepth;
+    if (!info.progress) {
+        _output << " multipv " << info.multiPv << " score ";
+        writeScore(_output, info.score);
+    }
+    _output << " nodes " << info.nodes
+            << " nps " << nps
+            << " time " << info.timeMs;
+    if (info.hashfull >= 0) {
+        _output << " hashfull " << info.hashfull;
+    }
+    if (info.tbHits > 0) {
+        _output << " tbhits " << info.tbHits;
+    }
+    if (!info.progress) {
+        _output << " pv";
+        for (const Move& move : info.pv) {
+            _output << ' ' << move;
         }
     }
+    _output << '\n';
+    
+    // Effective branching factor of the iteration, to measure pruning gains
+    if (info.branchingFactor > 0.0) {
+        _output << "info string ebf ";
+        _output.fixed(info.branchingFactor, 2) << '\n';
+    }
+    _output.flush();
 }
 
-std::vector<std::string> UCI::splitString(const std::string& str, char delimiter) {
-    std::vector<std::string> tokens;
-    std::string token;
-    std::istringstream tokenStream(str);
+void UCI::sendBestMove(const Move& move, const Move& ponderMove) {
+    std::lock_guard<std::mutex> lock(_outputMutex);
     
-    while (std::getline(tokenStream, token, delimiter)) {
-        tokens.push_back(token);
+    // An invalid move is sent as the null move 0000
+    _output << "bestmove " << move;
+    if (move.isValid() && ponderMove.isValid()) {
+        _output << " ponder " << ponderMove;
     }
-    
-    return tokens;
+    _output << '\n';
+    _output.flush();
 }
 
-void UCI::sendResponse(const std::string& response) {
-    std::cout << response << std::endl;
-}
\ No newline at end of file
+void UCI::writeScore(UciWriter& out, int score) {
+    if (score >= VALUE_MATE_IN_MAX_PLY) {
+        out << "mate " << (VALUE_MATE - score + 1) / 2;
+    } else if (score <= -VALUE_MATE_IN_MAX_PLY) {
+        out << "mate " << -(VALUE_MATE + score) / 2;
+    } else {
+        out << "cp " << score;
+    }
+}
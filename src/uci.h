@@ -2,9 +2,18 @@
 #define UCI_H
 
 #include "engine.h"
+#include "bench.h"
+#include "thread_pool.h"
+#include "uci_io.h"
+#include <atomic>
+#include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <sstream>
+#include <future>
+#include <thread>
+#include <mutex>
 
 // Include chess_rl.h only when RL is enabled
 #ifdef ENABLE_RL
@@ -14,14 +23,19 @@
 // UCI protocol handler
 class UCI {
 public:
-    // Constructor
-    UCI();
+    // Constructor: a session reading commands from in and writing to out, running
+    // its searches on the pool if one is given and on a thread of its own otherwise;
+    // sessions sharing a pool can't replace the process-wide bitbases
+    explicit UCI(std::istream& in = std::cin, std::ostream& out = std::cout, ThreadPool* pool = nullptr);
+    
+    // Destructor (stops and joins a running search)
+    ~UCI();
     
     // Start the UCI loop
     void startLoop();
     
     // Process a UCI command
-    void processCommand(const std::string& command);
+    void processCommand(std::string_view command);
 
 private:
     // The chess engine
@@ -30,13 +44,72 @@ private:
     // Board representation
     Board _board;
     
+    // Start position and moves of the last position command, so the next one
+    // only plays the moves added since
+    std::string _positionStart;
+    std::vector<Move> _positionMoves;
+    
+    // Hash keys of the positions played before the current one
+    std::vector<HashKey> _gameHistory;
+    
     // Flag to signal when to quit the UCI loop
     bool _quit;
     
+    // Command input of the session
+    std::istream& _in;
+    
+    // Thread running the current search, so commands are handled while it thinks
+    std::thread _searchThread;
+    
+    // Shared workers running the searches instead, and the current one's completion
+    ThreadPool* _pool;
+    std::future<void> _searchTask;
+    
+    // Set by whichever of the pool task and stopSearch gets to the current search
+    // first, so a search still queued is run stopped by the session instead of waited
+    // for; shared because the task may only leave the queue after the session ended
+    std::shared_ptr<std::atomic<bool>> _searchClaimed;
+    SearchLimits _searchLimits;
+    
+    // Best move of a finished infinite or ponder search, held until stop or
+    // ponderhit so the search doesn't keep its thread while it waits
+    std::mutex _bestMoveMutex;
+    bool _bestMovePending = false;
+    Move _pendingMove;
+    Move _pendingPonderMove;
+    
+    // Serializes output from the UCI and search threads
+    std::mutex _outputMutex;
+    
+    // Buffered session output, flushed once per response (guarded by _outputMutex)
+    UciWriter _output;
+
+    // Book file opened when OwnBook is enabled
+    std::string _bookFile = DEFAULT_BOOK_FILE;
+
+#ifdef ENABLE_RL
+    // Batching of the value network evaluations in the tree search
+    size_t _evalBatchSize = 1;
+    int64_t _evalBatchLatencyUs = DEFAULT_EVAL_BATCH_LATENCY_US;
+#endif
+    
+    // Stop a running search and wait for it to finish, then send its best move
+    void stopSearch();
+    
+    // Search the current position, sending the best move or holding it back
+    // while an infinite or ponder search waits for stop or ponderhit
+    void runSearch(const SearchLimits& limits);
+    
+    // Send the best move held back by runSearch, if any
+    void sendPendingBestMove();
+    
     // Handle the 'uci' command
     void handleUci();
 
-    void handleSetOption(std::istringstream& is);
+    void handleSetOption(UciTokenizer& tokens);
+    
+    // Open the configured book file, reporting failures to the GUI
+    void openBook();
 
     void handlePrintBoard();
     
@@ -44,28 +117,37 @@ private:
     void handleIsReady();
     
     // Handle the 'position' command
-    void handlePosition(std::istringstream& is);
+    void handlePosition(UciTokenizer& tokens);
     
     // Handle the 'go' command
-    void handleGo(std::istringstream& is);
+    void handleGo(UciTokenizer& tokens);
     
     // Handle the 'stop' command
     void handleStop();
     
+    // Handle the 'ponderhit' command
+    void handlePonderhit();
+    
     // Handle the 'quit' command
     void handleQuit();
     
     // Handle the 'ucinewgame' command
     void handleUciNewGame();
     
-    // Parse moves from a string (for the 'position' command)
-    void applyMoves(const std::string& moveStr);
+    // Handle the 'bench [depth]' command
+    void handleBench(UciTokenizer& tokens);
+    
+    // Send a single-line response to the GUI
+    void sendResponse(std::string_view response);
+    
+    // Send search progress to the GUI
+    void sendInfo(const SearchInfo& info);
     
-    // Split a string into tokens
-    std::vector<std::string> splitString(const std::string& str, char delimiter = ' ');
+    // Send the best move (and the reply to ponder on) once the search is done
+    void sendBestMove(const Move& move, const Move& ponderMove);
     
-    // Send a response to the GUI
-    void sendResponse(const std::string& response);
+    // Write a search score as "cp <x>" or "mate <y>"
+    static void writeScore(UciWriter& out, int score);
 };
 
 #endif // UCI_H
\ No newline at end of file
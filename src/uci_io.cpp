@@ -0,0 +1,62 @@
+#include "uci_io.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+}
+
+void UciTokenizer::skipWhitespace() {
+    size_t begin = 0;
+    while (begin < _rest.size() && isSpace(_rest[begin])) {
+        begin++;
+    }
+    _rest.remove_prefix(begin);
+}
+
+std::string_view UciTokenizer::next() {
+    skipWhitespace();
+    size_t end = 0;
+    while (end < _rest.size() && !isSpace(_rest[end])) {
+        end++;
+    }
+    std::string_view token = _rest.substr(0, end);
+    _rest.remove_prefix(end);
+    return token;
+}
+
+std::string_view UciTokenizer::rest() {
+    skipWhitespace();
+    std::string_view text = _rest;
+    while (!text.empty() && isSpace(text.back())) {
+        text.remove_suffix(1);
+    }
+    _rest = std::string_view();
+    return text;
+}
+
+bool UciTokenizer::empty() {
+    skipWhitespace();
+    return _rest.empty();
+}
+
+UciWriter::UciWriter(std::ostream& out) : _out(out) {
+    _buffer.reserve(DEFAULT_UCI_OUTPUT_BUFFER);
+}
+
+UciWriter& UciWriter::fixed(double value, int decimals) {
+    char digits[32];
+    int length = std::snprintf(digits, sizeof(digits), "%.*f", decimals, value);
+    if (length > 0) {
+        _buffer.append(digits, std::min<size_t>(static_cast<size_t>(length), sizeof(digits) - 1));
+    }
+    return *this;
+}
+
+void UciWriter::flush() {
+    _out.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+    _out.flush();
+    _buffer.clear();
+}
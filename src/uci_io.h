@@ -0,0 +1,100 @@
+#ifndef UCI_IO_H
+#define UCI_IO_H
+
+#include "board.h"
+#include <charconv>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Size of the buffer the writer keeps between flushes; longer responses grow it once
+constexpr size_t DEFAULT_UCI_OUTPUT_BUFFER = 4096;
+
+// Splits a command line into whitespace-separated tokens without copying it.
+// The tokens point into the line, which must outlive the tokenizer.
+class UciTokenizer {
+public:
+    explicit UciTokenizer(std::string_view line) : _rest(line) {}
+
+    // Next token, or an empty view at the end of the line
+    std::string_view next();
+
+    // Parse the next token as an integer; false (leaving value unchanged) if it isn't one
+    template<typename T>
+    bool next(T& value) {
+        static_assert(std::is_integral<T>::value, "UciTokenizer parses integers only");
+        std::string_view token = next();
+        T parsed;
+        auto result = std::from_chars(token.data(), token.data() + token.size(), parsed);
+        if (token.empty() || result.ec != std::errc() || result.ptr != token.data() + token.size()) {
+            return false;
+        }
+        value = parsed;
+        return true;
+    }
+
+    // The rest of the line with surrounding whitespace removed, for values that may contain spaces
+    std::string_view rest();
+
+    // Check if all tokens have been read
+    bool empty();
+
+private:
+    // Text not yet consumed
+    std::string_view _rest;
+
+    // Drop leading whitespace from the unconsumed text
+    void skipWhitespace();
+};
+
+// Collects the lines of a response and writes them to the stream with a single
+// flush, reusing its buffer so steady-state output doesn't allocate.
+// Not synchronized: callers serialize access.
+class UciWriter {
+public:
+    explicit UciWriter(std::ostream& out);
+
+    UciWriter& operator<<(std::string_view text) {
+        _buffer.append(text.data(), text.size());
+        return *this;
+    }
+
+    UciWriter& operator<<(const char* text) {
+        return *this << std::string_view(text);
+    }
+
+    UciWriter& operator<<(char c) {
+        _buffer.push_back(c);
+        return *this;
+    }
+
+    UciWriter& operator<<(const Move& move) {
+        char uci[MAX_UCI_MOVE_LENGTH];
+        _buffer.append(uci, move.toUci(uci));
+        return *this;
+    }
+
+    template<typename T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
+    UciWriter& operator<<(T value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        _buffer.append(digits, result.ptr);
+        return *this;
+    }
+
+    // Append a number with a fixed number of decimals
+    UciWriter& fixed(double value, int decimals);
+
+    // Write the buffered text and flush the stream
+    void flush();
+
+    // Text buffered since the last flush
+    std::string_view pending() const { return _buffer; }
+
+private:
+    std::ostream& _out;
+    std::string _buffer;
+};
+
+#endif // UCI_IO_H
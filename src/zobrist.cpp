@@ -0,0 +1,106 @@
+#include "zobrist.h"
+#include "board.h"
+
+namespace {
+    // SplitMix64 step, used to fill the key tables at compile time
+    constexpr HashKey splitMix64(HashKey& state) {
+        HashKey z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // All keys generated from a single fixed seed so hashes are reproducible
+    struct KeyTables {
+        std::array<std::array<std::array<HashKey, 64>, 6>, 2> pieces{};
+        std::array<HashKey, 16> castling{};
+        std::array<HashKey, 8> enPassant{};
+        HashKey side = 0;
+    };
+
+    constexpr KeyTables generateKeys() {
+        KeyTables tables;
+        HashKey state = 0x2545F4914F6CDD1DULL;
+
+        for (int color = WHITE; color <= BLACK; ++color) {
+            for (int piece = PAWN; piece <= KING; ++piece) {
+                for (int sq = 0; sq < 64; ++sq) {
+                    tables.pieces[color][piece][sq] = splitMix64(state);
+                }
+            }
+        }
+
+        // Castling keys are composed from the four individual rights so that
+        // clearing one right always toggles the same key
+        std::array<HashKey, 4> rightKeys{};
+        for (int i = 0; i < 4; ++i) {
+            rightKeys[i] = splitMix64(state);
+        }
+        for (int rights = 0; rights < 16; ++rights) {
+            HashKey key = 0;
+            for (int i = 0; i < 4; ++i) {
+                if (rights & (1 << i)) {
+                    key ^= rightKeys[i];
+                }
+            }
+            tables.castling[rights] = key;
+        }
+
+        for (int file = FILE_A; file <= FILE_H; ++file) {
+            tables.enPassant[file] = splitMix64(state);
+        }
+
+        tables.side = splitMix64(state);
+        return tables;
+    }
+
+    constexpr KeyTables KEYS = generateKeys();
+}
+
+namespace Zobrist {
+    const std::array<std::array<std::array<HashKey, 64>, 6>, 2> PIECE_KEYS = KEYS.pieces;
+    const std::array<HashKey, 16> CASTLING_KEYS = KEYS.castling;
+    const std::array<HashKey, 8> EN_PASSANT_KEYS = KEYS.enPassant;
+    const HashKey SIDE_KEY = KEYS.side;
+
+    HashKey computeKey(const Board& board) {
+        HashKey key = 0;
+
+        for (int color = WHITE; color <= BLACK; ++color) {
+            for (int piece = PAWN; piece <= KING; ++piece) {
+                Bitboard bb = board._pieces[color][piece];
+                while (bb) {
+                    Square sq = BitboardUtils::lsb(bb);
+                    key ^= PIECE_KEYS[color][piece][sq];
+                    bb &= bb - 1;
+                }
+            }
+        }
+
+        key ^= CASTLING_KEYS[board._castlingRights & ANY_CASTLING];
+
+        if (board._enPassantSquare != NO_SQUARE) {
+            key ^= EN_PASSANT_KEYS[BitboardUtils::squareFile(board._enPassantSquare)];
+        }
+
+        if (board._sideToMove == BLACK) {
+            key ^= SIDE_KEY;
+        }
+
+        return key;
+    }
+
+    HashKey computePawnKey(const Board& board) {
+        HashKey key = 0;
+
+        for (int color = WHITE; color <= BLACK; ++color) {
+            Bitboard bb = board._pieces[color][PAWN];
+            while (bb) {
+                key ^= PIECE_KEYS[color][PAWN][BitboardUtils::lsb(bb)];
+                bb &= bb - 1;
+            }
+        }
+
+        return key;
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "bitboard.h"
+#include <array>
+
+// Type definition for a position hash key
+using HashKey = uint64_t;
+
+class Board;
+
+// Zobrist hashing keys and helpers
+namespace Zobrist {
+    // Keys for each piece on each square, indexed by [color][piece_type][square]
+    extern const std::array<std::array<std::array<HashKey, 64>, 6>, 2> PIECE_KEYS;
+
+    // Keys for each combination of castling rights
+    extern const std::array<HashKey, 16> CASTLING_KEYS;
+
+    // Keys for the file of the en passant square
+    extern const std::array<HashKey, 8> EN_PASSANT_KEYS;
+
+    // Key toggled when black is to move
+    extern const HashKey SIDE_KEY;
+
+    // Compute the full hash key of a position from scratch
+    HashKey computeKey(const Board& board);
+
+    // Compute the key of the pawn structure alone (the pawn keys of both colors)
+    HashKey computePawnKey(const Board& board);
+}
+
+#endif // ZOBRIST_H
@@ -0,0 +1,73 @@
+#include "gtest/gtest.h"
+#include "accumulator.h"
+#include "chess_rl.h"
+#include <vector>
+#include <cmath>
+
+class AccumulatorTest : public ::testing::Test {
+protected:
+    AccumulatorTest() : network(valueNetworkTopology()), accumulator(network) {}
+
+    void SetUp() override {
+        BitboardUtils::initBitboards();
+        board.reset();
+    }
+
+    // The incremental value matches a full forward pass over the extracted features
+    void expectMatchesFullEvaluation() {
+        float full = network.evaluate(BoardFeatureExtractor::extractFeatures(board));
+        EXPECT_NEAR(accumulator.evaluate(), full, 1e-4f);
+    }
+
+    NeuralNetwork network;
+    Accumulator accumulator;
+    Board board;
+};
+
+TEST_F(AccumulatorTest, RefreshMatchesForwardPass) {
+    accumulator.refresh(board);
+    EXPECT_EQ(accumulator.size(), 1u);
+    expectMatchesFullEvaluation();
+}
+
+TEST_F(AccumulatorTest, IncrementalUpdatesMatchForwardPass) {
+    // Castling, en passant, captures and a promotion
+    ASSERT_TRUE(board.setFromFen("r3k2r/1P6/8/8/4p3/8/3P1P2/R3K2R w KQkq - 0 1"));
+    accumulator.refresh(board);
+    const Move moves[] = {
+        Move(D2, D4), Move(E4, D3), Move(E1, G1), Move(E8, G8),
+        Move(B7, B8, QUEEN), Move(A8, B8)
+    };
+    for (const Move& move : moves) {
+        ASSERT_TRUE(board.makeMove(move)) << move.toUci();
+        accumulator.push(board);
+        expectMatchesFullEvaluation();
+    }
+    EXPECT_EQ(accumulator.size(), 7u);
+    EXPECT_EQ(accumulator.updateCount(), 6u);
+    EXPECT_EQ(accumulator.refreshCount(), 1u);
+}
+
+TEST_F(AccumulatorTest, PopRestoresPreviousPly) {
+    accumulator.refresh(board);
+    std::vector<float> root = accumulator.preActivations();
+
+    Board child = board;
+    ASSERT_TRUE(child.makeMove(Move(G1, F3)));
+    accumulator.push(child);
+    EXPECT_NE(accumulator.preActivations(), root);
+
+    accumulator.pop();
+    EXPECT_EQ(accumulator.size(), 1u);
+    EXPECT_EQ(accumulator.preActivations(), root);
+    expectMatchesFullEvaluation();
+}
+
+TEST_F(AccumulatorTest, UnrelatedPositionIsRefreshed) {
+    accumulator.refresh(board);
+    ASSERT_TRUE(board.setFromFen("4k3/8/8/8/8/8/8/3QK3 w - - 0 1"));
+    accumulator.push(board);
+    EXPECT_EQ(accumulator.refreshCount(), 2u);
+    EXPECT_EQ(accumulator.updateCount(), 0u);
+    expectMatchesFullEvaluation();
+}
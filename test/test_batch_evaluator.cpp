@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include "batch_evaluator.h"
+#include "chess_rl.h"
+#include "feature_extractor.h"
+#include <vector>
+#include <thread>
+#include <cmath>
+
+TEST(BatchEvaluatorTest, MatchesDirectEvaluation) {
+    auto network = std::make_shared<NeuralNetwork>(valueNetworkTopology());
+    BatchEvaluator batcher(network, 4);
+
+    Board board;
+    board.reset();
+    float white = network->evaluate(BoardFeatureExtractor::extractFeatures(board));
+    EXPECT_NEAR(batcher.evaluate(board), white, 1e-5f);
+
+    // Values are returned from the side to move's point of view
+    board.makeMove(Move(E2, E4));
+    float afterMove = network->evaluate(BoardFeatureExtractor::extractFeatures(board));
+    EXPECT_NEAR(batcher.evaluate(board), -afterMove, 1e-5f);
+}
+
+TEST(BatchEvaluatorTest, PartialBatchIsFlushed) {
+    // A single caller can never fill the batch, the latency deadline must release it
+    auto network = std::make_shared<NeuralNetwork>(valueNetworkTopology());
+    BatchEvaluator batcher(network, 64, std::chrono::microseconds(500));
+
+    Board board;
+    board.reset();
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(std::isfinite(batcher.evaluate(board)));
+    }
+    EXPECT_EQ(batcher.batchCount(), 3u);
+    EXPECT_EQ(batcher.positionCount(), 3u);
+}
+
+TEST(BatchEvaluatorTest, CollectsPositionsFromManyThreads) {
+    auto network = std::make_shared<NeuralNetwork>(valueNetworkTopology());
+    const int threads = 8;
+    const int perThread = 20;
+    BatchEvaluator batcher(network, threads, std::chrono::microseconds(20000));
+
+    std::vector<std::thread> workers;
+    std::vector<int> mismatches(threads, 0);
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            Board board;
+            board.reset();
+            float expected = network->evaluate(BoardFeatureExtractor::extractFeatures(board));
+            for (int i = 0; i < perThread; i++) {
+                if (std::fabs(batcher.evaluate(board) - expected) > 1e-5f) {
+                    mismatches[t]++;
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (int t = 0; t < threads; t++) {
+        EXPECT_EQ(mismatches[t], 0);
+    }
+    EXPECT_EQ(batcher.positionCount(), static_cast<uint64_t>(threads * perThread));
+
+    // Concurrent callers share forward passes
+    EXPECT_LT(batcher.batchCount(), static_cast<uint64_t>(threads * perThread));
+}
+
+TEST(BatchEvaluatorTest, DrivesTreeSearch) {
+    auto network = std::make_shared<NeuralNetwork>(valueNetworkTopology());
+    auto batcher = std::make_shared<BatchEvaluator>(network, 4);
+
+    MCTS mcts;
+    mcts.options().threads = 4;
+    mcts.setEvaluator(batchedNetworkEvaluator(batcher));
+
+    Board board;
+    board.reset();
+    SearchLimits limits;
+    limits.nodes = 200;
+    SearchResult result = mcts.run(board, limits);
+
+    EXPECT_TRUE(result.bestMove.isValid());
+    EXPECT_GE(batcher->positionCount(), 200u);
+}
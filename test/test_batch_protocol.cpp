@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+#include "batch_protocol.h"
+#include "chess_rl.h"
+#include "feature_extractor.h"
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class BatchProtocolTest : public ::testing::Test {
+protected:
+    BatchProtocolTest() : network(valueNetworkTopology()) {}
+
+    void SetUp() override {
+        BitboardUtils::initBitboards();
+    }
+
+    // Packed positions of FEN strings
+    static std::string pack(const std::vector<std::string>& fens) {
+        std::string packed;
+        for (const std::string& fen : fens) {
+            Board board;
+            EXPECT_TRUE(board.setFromFen(fen));
+            uint8_t bytes[PACKED_BOARD_SIZE];
+            board.pack(bytes);
+            packed.append(reinterpret_cast<const char*>(bytes), PACKED_BOARD_SIZE);
+        }
+        return packed;
+    }
+
+    static float readValue(const std::string& results, size_t offset) {
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; i++) {
+            bits |= static_cast<uint32_t>(static_cast<uint8_t>(results[offset + i])) << (8 * i);
+        }
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    static uint16_t readMove(const std::string& results, size_t offset) {
+        return static_cast<uint16_t>(static_cast<uint8_t>(results[offset]) |
+                                     (static_cast<uint8_t>(results[offset + 1]) << 8));
+    }
+
+    NeuralNetwork network;
+};
+
+TEST_F(BatchProtocolTest, WritesNetworkValues) {
+    std::vector<std::string> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1",
+        "8/8/4k3/8/8/4K3/4P3/8 w - - 0 1",
+    };
+    std::string packed = pack(fens);
+
+    // An invalid position (no pieces) and a trailing partial position
+    packed.append(PACKED_BOARD_SIZE, '\0');
+    packed.append(PACKED_BOARD_SIZE / 2, '\0');
+
+    std::istringstream in(packed);
+    std::ostringstream out;
+    BatchProtocol protocol(network, ProtocolResult::Value, 2);
+    EXPECT_EQ(protocol.run(in, out), 4u);
+    EXPECT_EQ(protocol.batchCount(), 2u);
+
+    std::string results = out.str();
+    ASSERT_EQ(results.size(), 4 * BatchProtocol::resultSize(ProtocolResult::Value));
+    for (size_t i = 0; i < fens.size(); i++) {
+        // Values are for the side to move
+        Board board;
+        board.setFromFen(fens[i]);
+        float white = network.evaluate(BoardFeatureExtractor::extractFeatures(board));
+        float expected = board.sideToMove() == WHITE ? white : -white;
+        EXPECT_NEAR(readValue(results, i * 4), expected, 1e-5f);
+    }
+    EXPECT_TRUE(std::isnan(readValue(results, 12)));
+}
+
+TEST_F(BatchProtocolTest, WritesBestMoves) {
+    std::string packed = pack({
+        "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1",
+        "R5k1/5ppp/8/8/8/8/8/6K1 b - - 1 1",
+        "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    });
+
+    std::istringstream in(packed);
+    std::ostringstream out;
+    BatchProtocol protocol(network, ProtocolResult::MoveAndScore);
+    EXPECT_EQ(protocol.run(in, out), 4u);
+    EXPECT_EQ(protocol.batchCount(), 1u);
+
+    std::string results = out.str();
+    const size_t size = BatchProtocol::resultSize(ProtocolResult::MoveAndScore);
+    ASSERT_EQ(results.size(), 4 * size);
+
+    // A mate in one is played and scores a win
+    EXPECT_EQ(readMove(results, 0), Move(A1, A8).pack());
+    EXPECT_EQ(readValue(results, 2), 1.0f);
+
+    // Checkmate and stalemate have no move
+    EXPECT_EQ(readMove(results, size), 0);
+    EXPECT_EQ(readValue(results, size + 2), -1.0f);
+    EXPECT_EQ(readMove(results, 2 * size), 0);
+    EXPECT_EQ(readValue(results, 2 * size + 2), 0.0f);
+
+    // Otherwise the move leading to the best network value
+    Board board;
+    board.reset();
+    Move expected;
+    float bestValue = -1e9f;
+    for (const Move& move : board.generateLegalMoves()) {
+        Board child = board;
+        child.makeMove(move);
+        float value = network.evaluate(BoardFeatureExtractor::extractFeatures(child));
+        if (value > bestValue) {
+            bestValue = value;
+            expected = move;
+        }
+    }
+    EXPECT_EQ(readMove(results, 3 * size), expected.pack());
+    EXPECT_NEAR(readValue(results, 3 * size + 2), bestValue, 1e-5f);
+}
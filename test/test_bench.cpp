@@ -0,0 +1,33 @@
+#include "bench.h"
+#include <gtest/gtest.h>
+
+class BenchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        BitboardUtils::initBitboards();
+    }
+};
+
+TEST_F(BenchTest, PositionsAreValid) {
+    EXPECT_GE(Bench::positions().size(), 40u);
+    for (const std::string& fen : Bench::positions()) {
+        Board board;
+        ASSERT_TRUE(board.setFromFen(fen)) << fen;
+        EXPECT_FALSE(board.generateLegalMoves().empty()) << fen;
+    }
+}
+
+TEST_F(BenchTest, NodeCountIsDeterministic) {
+    size_t reported = 0;
+    BenchResult first = Bench::run(3, [&](size_t index, const std::string& fen, const SearchResult& result) {
+        EXPECT_EQ(fen, Bench::positions()[index]);
+        EXPECT_TRUE(result.bestMove.isValid());
+        reported++;
+    });
+    EXPECT_EQ(first.positions, static_cast<int>(Bench::positions().size()));
+    EXPECT_EQ(reported, Bench::positions().size());
+    EXPECT_GT(first.nodes, 0u);
+
+    BenchResult second = Bench::run(3);
+    EXPECT_EQ(second.nodes, first.nodes);
+}
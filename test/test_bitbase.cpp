@@ -0,0 +1,124 @@
+#include "bitbase.h"
+#include "board.h"
+#include "search.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+class BitbaseTest : public ::testing::Test {
+protected:
+    // Generating takes a moment, so the 3-piece tables are built once for all tests
+    static void SetUpTestSuite() {
+        BitboardUtils::initBitboards();
+        Bitbases::clear();
+        for (const Bitbases::Ending& ending : Bitbases::endings()) {
+            if (ending.name.size() > 3) {
+                continue;
+            }
+            std::vector<uint8_t> table;
+            ASSERT_TRUE(Bitbases::generate(ending, table, 2)) << ending.name;
+            Bitbases::add(ending, table);
+            tables.push_back(table);
+        }
+    }
+
+    static void TearDownTestSuite() {
+        Bitbases::clear();
+        tables.clear();
+    }
+
+    void SetUp() override {
+        // Tests may replace the tables, start each one with all three
+        const std::vector<Bitbases::Ending>& endings = Bitbases::endings();
+        for (size_t i = 0; i < tables.size(); ++i) {
+            Bitbases::add(endings[i], tables[i]);
+        }
+    }
+
+    Bitbases::WDL probeFen(const std::string& fen) {
+        Board board;
+        EXPECT_TRUE(board.setFromFen(fen));
+        Bitbases::WDL wdl = Bitbases::DRAW;
+        EXPECT_TRUE(Bitbases::probe(board, wdl)) << fen;
+        return wdl;
+    }
+
+    static std::vector<std::vector<uint8_t>> tables;
+};
+
+std::vector<std::vector<uint8_t>> BitbaseTest::tables;
+
+TEST_F(BitbaseTest, QueenAndRookWin) {
+    EXPECT_EQ(Bitbases::maxPieces(), 3);
+    EXPECT_EQ(probeFen("4k3/8/8/8/8/8/8/R3K3 w - - 0 1"), Bitbases::WIN);
+    EXPECT_EQ(probeFen("4k3/8/8/8/8/8/8/R3K3 b - - 0 1"), Bitbases::LOSS);
+    EXPECT_EQ(probeFen("7k/5Q2/6K1/8/8/8/8/8 w - - 0 1"), Bitbases::WIN);
+
+    // Stalemate, and a queen the lone king can take
+    EXPECT_EQ(probeFen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1"), Bitbases::DRAW);
+    EXPECT_EQ(probeFen("7k/6Q1/8/8/8/8/8/K7 b - - 0 1"), Bitbases::DRAW);
+
+    // The stronger side may be Black
+    EXPECT_EQ(probeFen("3qk3/8/8/8/8/8/8/4K3 w - - 0 1"), Bitbases::LOSS);
+}
+
+TEST_F(BitbaseTest, KingAndPawn) {
+    // King in front of its pawn on the sixth rank wins whoever moves
+    EXPECT_EQ(probeFen("4k3/8/4K3/4P3/8/8/8/8 w - - 0 1"), Bitbases::WIN);
+    EXPECT_EQ(probeFen("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1"), Bitbases::LOSS);
+
+    // Defending king in front of the pawn, and a rook pawn with the king in the corner
+    EXPECT_EQ(probeFen("8/8/8/4k3/8/8/4P3/4K3 w - - 0 1"), Bitbases::DRAW);
+    EXPECT_EQ(probeFen("k7/8/8/8/8/8/P7/K7 w - - 0 1"), Bitbases::DRAW);
+
+    // Black pawn, mirrored
+    EXPECT_EQ(probeFen("8/8/8/8/4p3/4k3/8/4K3 b - - 0 1"), Bitbases::WIN);
+}
+
+TEST_F(BitbaseTest, UncoveredPositionsAreNotProbed) {
+    Board board;
+    board.reset();
+    Bitbases::WDL wdl;
+    EXPECT_FALSE(Bitbases::probe(board, wdl));
+
+    ASSERT_TRUE(board.setFromFen("4k3/8/8/8/8/8/8/2B1K3 w - - 0 1"));
+    EXPECT_FALSE(Bitbases::probe(board, wdl));
+}
+
+TEST_F(BitbaseTest, GenerationNeedsConvertedEndings) {
+    Bitbases::clear();
+    std::vector<uint8_t> table;
+    EXPECT_FALSE(Bitbases::generate(Bitbases::endings()[2], table));
+}
+
+TEST_F(BitbaseTest, SavesAndLoads) {
+    const std::string directory = "test_bitbases";
+    std::filesystem::create_directories(directory);
+    const Bitbases::Ending& krk = Bitbases::endings()[1];
+    ASSERT_TRUE(Bitbases::save(Bitbases::tableFile(directory, krk), tables[1]));
+
+    Bitbases::clear();
+    EXPECT_EQ(Bitbases::load(directory), 1);
+    EXPECT_EQ(probeFen("4k3/8/8/8/8/8/8/R3K3 w - - 0 1"), Bitbases::WIN);
+
+    Bitbases::clear();
+    std::filesystem::remove_all(directory);
+}
+
+TEST_F(BitbaseTest, SearchKeepsWinningMoves) {
+    // The queen is attacked: most moves give it away
+    Board board;
+    ASSERT_TRUE(board.setFromFen("8/8/8/8/8/8/2kQ4/K7 w - - 0 1"));
+
+    Search search;
+    SearchLimits limits;
+    limits.depth = 2;
+    SearchResult result = search.run(board, limits);
+
+    Board child = board;
+    ASSERT_TRUE(child.makeMove(result.bestMove));
+    Bitbases::WDL wdl;
+    ASSERT_TRUE(Bitbases::probe(child, wdl));
+    EXPECT_EQ(wdl, Bitbases::LOSS);
+}
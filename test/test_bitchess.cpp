@@ -0,0 +1,104 @@
+#include "gtest/gtest.h"
+#include "bitchess.h"
+#include "chess_rl.h"
+#include "feature_extractor.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+TEST(BitchessApiTest, ReportsTheProjectVersion) {
+    EXPECT_STREQ(bitchess_version(), BITCHESS_VERSION);
+}
+
+TEST(BitchessApiTest, PlaysMovesOnABoard) {
+    bitchess_board* board = bitchess_board_new(nullptr);
+    ASSERT_NE(board, nullptr);
+
+    uint16_t moves[BITCHESS_MAX_MOVES];
+    EXPECT_EQ(bitchess_generate_moves(board, moves, BITCHESS_MAX_MOVES), 20u);
+
+    // A short buffer receives the first moves, the count is still the total
+    uint16_t first[4];
+    EXPECT_EQ(bitchess_generate_moves(board, first, 4), 20u);
+    EXPECT_EQ(first[0], moves[0]);
+
+    EXPECT_TRUE(bitchess_make_move(board, bitchess_move_from_uci("e2e4")));
+    EXPECT_FALSE(bitchess_make_move(board, bitchess_move_from_uci("e4e6")));
+    EXPECT_FALSE(bitchess_make_move(board, 0));
+
+    char fen[128];
+    ASSERT_GT(bitchess_board_fen(board, fen, sizeof(fen)), 0u);
+    EXPECT_EQ(std::string(fen), "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+    EXPECT_EQ(bitchess_board_fen(board, fen, 10), 0u);
+
+    char uci[BITCHESS_UCI_MOVE_SIZE];
+    EXPECT_EQ(bitchess_move_to_uci(bitchess_move_from_uci("a7a8q"), uci), 5u);
+    EXPECT_EQ(std::string(uci), "a7a8q");
+
+    bitchess_board_free(board);
+    EXPECT_EQ(bitchess_board_new("not a fen"), nullptr);
+}
+
+TEST(BitchessApiTest, EvaluatesBatchesWithTheNetwork) {
+    // A saved network of the engine's topology
+    NeuralNetwork network(valueNetworkTopology());
+    std::string path = ::testing::TempDir() + "bitchess_api_network.bin";
+    ASSERT_TRUE(network.save(path));
+    bitchess_network* loaded = bitchess_network_load(path.c_str());
+    ASSERT_NE(loaded, nullptr);
+
+    std::vector<bitchess_board*> boards = {
+        bitchess_board_new(nullptr),
+        bitchess_board_new("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3"),
+        bitchess_board_new("8/8/4k3/8/8/4K3/4P3/8 b - - 0 1"),
+    };
+
+    // Features are written row by row, as the extractor computes them
+    const size_t size = bitchess_feature_size();
+    std::vector<float> features(boards.size() * size);
+    bitchess_extract_features(boards.data(), boards.size(), features.data());
+
+    std::vector<float> values(boards.size());
+    bitchess_network_evaluate(loaded, boards.data(), boards.size(), values.data());
+    for (size_t i = 0; i < boards.size(); ++i) {
+        std::vector<float> row(features.begin() + i * size, features.begin() + (i + 1) * size);
+        EXPECT_NEAR(values[i], network.evaluate(row), 1e-5f);
+    }
+
+    std::vector<float> fromFeatures(boards.size());
+    bitchess_network_evaluate_features(loaded, features.data(), boards.size(), fromFeatures.data());
+    EXPECT_EQ(fromFeatures, values);
+
+    for (bitchess_board* board : boards) {
+        bitchess_board_free(board);
+    }
+    bitchess_network_free(loaded);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(bitchess_network_load("missing_network.bin"), nullptr);
+}
+
+TEST(BitchessApiTest, SearchesBatchesOfPositions) {
+    std::vector<bitchess_board*> boards = {
+        bitchess_board_new("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1"),
+        bitchess_board_new("r5k1/8/8/8/8/8/5PPP/6K1 b - - 0 1"),
+    };
+    std::vector<bitchess_result> results(boards.size());
+
+    bitchess_search* search = bitchess_search_new(1);
+    bitchess_limits limits = {3, 0, 0};
+    bitchess_search_run(search, boards.data(), boards.size(), &limits, results.data());
+
+    EXPECT_EQ(results[0].best_move, bitchess_move_from_uci("a1a8"));
+    EXPECT_EQ(results[1].best_move, bitchess_move_from_uci("a8a1"));
+    for (const bitchess_result& result : results) {
+        EXPECT_GE(result.depth, 1);
+        EXPECT_GT(result.score, 30000);
+        EXPECT_GT(result.nodes, 0u);
+    }
+
+    bitchess_search_free(search);
+    for (bitchess_board* board : boards) {
+        bitchess_board_free(board);
+    }
+}
@@ -1,5 +1,6 @@
 #include "board.h"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <string>
 
 class BoardTest : public ::testing::Test {
@@ -199,4 +200,101 @@ TEST_F(BoardTest, InsufficientMaterial) {
     // K+N vs K+N
     EXPECT_TRUE(board.setFromFen("8/8/8/4k3/8/1n6/3N4/4K3 w - - 0 1"));
     EXPECT_FALSE(board.isInsufficientMaterial());
-}
\ No newline at end of file
+}
+
+TEST_F(BoardTest, HashUpdatedIncrementally) {
+    // Play moves covering castling, en passant and promotion
+    EXPECT_TRUE(board.setFromFen("r3k2r/pP1p4/8/4P3/8/8/5PPP/R3K2R b KQkq - 0 1"));
+    EXPECT_EQ(board.hash(), Zobrist::computeKey(board));
+    
+    const Move moves[] = {Move(D7, D5), Move(E5, D6), Move(E8, G8), Move(E1, C1),
+                          Move(A8, A2), Move(B7, B8, QUEEN)};
+    for (const Move& move : moves) {
+        EXPECT_TRUE(board.makeMove(move));
+        EXPECT_EQ(board.hash(), Zobrist::computeKey(board)) << move.toUci();
+        EXPECT_EQ(board.pawnHash(), Zobrist::computePawnKey(board)) << move.toUci();
+    }
+    
+    // Same position reached through a different move order has the same key
+    Board other;
+    EXPECT_TRUE(other.setFromFen(board.getFen()));
+    EXPECT_EQ(board.hash(), other.hash());
+}
+
+TEST_F(BoardTest, NullMove) {
+    EXPECT_TRUE(board.makeMove(Move(E2, E4)));
+    HashKey before = board.hash();
+    
+    board.makeNullMove();
+    EXPECT_EQ(board.sideToMove(), WHITE);
+    EXPECT_EQ(board.enPassantSquare(), NO_SQUARE);
+    EXPECT_NE(board.hash(), before);
+    EXPECT_EQ(board.hash(), Zobrist::computeKey(board));
+}
+
+TEST_F(BoardTest, PackedRoundTrip) {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/pP1p4/8/4P3/8/8/5PPP/R3K2R b Kq - 7 42",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+        "8/8/4k3/8/8/4K3/8/8 w - - 99 300",
+    };
+    for (const char* fen : fens) {
+        Board original;
+        ASSERT_TRUE(original.setFromFen(fen));
+        uint8_t packed[PACKED_BOARD_SIZE];
+        original.pack(packed);
+        
+        ASSERT_TRUE(board.unpack(packed)) << fen;
+        EXPECT_EQ(board.getFen(), fen);
+        EXPECT_EQ(board.hash(), original.hash());
+    }
+}
+
+TEST_F(BoardTest, UnpackRejectsInvalidPositions) {
+    uint8_t packed[PACKED_BOARD_SIZE];
+    board.pack(packed);
+    
+    // An unknown piece code
+    uint8_t badCode[PACKED_BOARD_SIZE];
+    std::copy(packed, packed + PACKED_BOARD_SIZE, badCode);
+    badCode[8] |= 0x0C;
+    EXPECT_FALSE(board.unpack(badCode));
+    
+    // No black king (the e8 king becomes a white one)
+    uint8_t twoKings[PACKED_BOARD_SIZE];
+    std::copy(packed, packed + PACKED_BOARD_SIZE, twoKings);
+    twoKings[8 + 28 / 2] = static_cast<uint8_t>((twoKings[8 + 28 / 2] & 0xF0) | KING);
+    EXPECT_FALSE(board.unpack(twoKings));
+    
+    // More than 32 pieces
+    uint8_t crowded[PACKED_BOARD_SIZE];
+    std::copy(packed, packed + PACKED_BOARD_SIZE, crowded);
+    crowded[3] = 0x01;
+    EXPECT_FALSE(board.unpack(crowded));
+    
+    // An en passant square without a pawn in front of it, and one on the wrong rank
+    uint8_t noPawn[PACKED_BOARD_SIZE];
+    std::copy(packed, packed + PACKED_BOARD_SIZE, noPawn);
+    noPawn[25] = E6;
+    EXPECT_FALSE(board.unpack(noPawn));
+    noPawn[25] = E3;
+    EXPECT_FALSE(board.unpack(noPawn));
+    
+    // A rejected position leaves the board as it was
+    EXPECT_EQ(board.getFen(), "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    EXPECT_EQ(board.hash(), Zobrist::computeKey(board));
+}
+
+TEST_F(BoardTest, UnpackDropsCastlingRightsWithoutKingAndRook) {
+    Board original;
+    ASSERT_TRUE(original.setFromFen("4k3/8/8/8/8/8/8/4K2R w KQkq - 0 1"));
+    uint8_t packed[PACKED_BOARD_SIZE];
+    original.pack(packed);
+    
+    ASSERT_TRUE(board.unpack(packed));
+    EXPECT_EQ(board.castlingRights(), WHITE_OO);
+    std::vector<Move> moves = board.generateLegalMoves();
+    EXPECT_NE(std::find(moves.begin(), moves.end(), Move(E1, G1)), moves.end());
+    EXPECT_EQ(std::find(moves.begin(), moves.end(), Move(E1, C1)), moves.end());
+}
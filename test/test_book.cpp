@@ -0,0 +1,150 @@
+#include "book.h"
+#include "board.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class BookTest : public ::testing::Test {
+protected:
+    struct Entry {
+        HashKey key;
+        uint16_t move;
+        uint16_t weight;
+    };
+
+    void SetUp() override {
+        BitboardUtils::initBitboards();
+        board.reset();
+    }
+
+    void TearDown() override {
+        book.close();
+        std::remove(BOOK_FILE);
+    }
+
+    // Polyglot move encoding: to square, from square, promotion piece
+    static uint16_t encode(Square from, Square to, int promotion = 0) {
+        return static_cast<uint16_t>(to | (from << 6) | (promotion << 12));
+    }
+
+    // Write a book with its entries sorted by key, as Polyglot requires
+    static void writeBook(std::vector<Entry> entries) {
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const Entry& a, const Entry& b) { return a.key < b.key; });
+        std::ofstream file(BOOK_FILE, std::ios::binary);
+        for (const Entry& entry : entries) {
+            unsigned char bytes[16] = {};
+            for (int i = 0; i < 8; ++i) {
+                bytes[i] = static_cast<unsigned char>(entry.key >> (56 - 8 * i));
+            }
+            bytes[8] = static_cast<unsigned char>(entry.move >> 8);
+            bytes[9] = static_cast<unsigned char>(entry.move);
+            bytes[10] = static_cast<unsigned char>(entry.weight >> 8);
+            bytes[11] = static_cast<unsigned char>(entry.weight);
+            file.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+        }
+    }
+
+    void play(const std::vector<std::string>& moves) {
+        for (const std::string& uci : moves) {
+            ASSERT_TRUE(board.makeMove(Move::fromUci(uci))) << uci;
+        }
+    }
+
+    static constexpr const char* BOOK_FILE = "test_book.bin";
+
+    Board board;
+    Book book;
+};
+
+TEST_F(BookTest, PolyglotKeysMatchSpecification) {
+    // Test positions from the Polyglot book format description
+    EXPECT_EQ(Polyglot::key(board), 0x463B96181691FC9CULL);
+    play({"e2e4"});
+    EXPECT_EQ(Polyglot::key(board), 0x823C9B50FD114196ULL);
+    play({"d7d5"});
+    EXPECT_EQ(Polyglot::key(board), 0x0756B94461C50FB0ULL);
+    play({"e4e5"});
+    EXPECT_EQ(Polyglot::key(board), 0x662FAFB965DB29D4ULL);
+    play({"f7f5"});
+    EXPECT_EQ(Polyglot::key(board), 0x22A48B5A8E47FF78ULL);
+    play({"e1e2"});
+    EXPECT_EQ(Polyglot::key(board), 0x652A607CA3F242C1ULL);
+    play({"e8f7"});
+    EXPECT_EQ(Polyglot::key(board), 0x00FDD303C946BDD9ULL);
+
+    board.reset();
+    play({"a2a4", "b7b5", "h2h4", "b5b4", "c2c4"});
+    EXPECT_EQ(Polyglot::key(board), 0x3C8123EA7B067637ULL);
+    play({"b4c3", "a1a3"});
+    EXPECT_EQ(Polyglot::key(board), 0x5C3F9B829B279560ULL);
+}
+
+TEST_F(BookTest, FindsMovesForPosition) {
+    HashKey start = Polyglot::key(board);
+    writeBook({
+        {start - 1, encode(A2, A3), 5},
+        {start, encode(E2, E4), 30},
+        {start, encode(D2, D4), 10},
+        {start, encode(E2, E5), 10},   // Illegal, skipped
+        {start + 1, encode(H2, H3), 5},
+    });
+    ASSERT_TRUE(book.open(BOOK_FILE));
+    EXPECT_EQ(book.size(), 5u);
+
+    std::vector<BookMove> moves = book.moves(board);
+    ASSERT_EQ(moves.size(), 2u);
+    EXPECT_EQ(moves[0].move, Move(E2, E4));
+    EXPECT_EQ(moves[0].weight, 30);
+    EXPECT_EQ(moves[1].move, Move(D2, D4));
+
+    // Picks follow the weights
+    std::mt19937 rng(42);
+    int e4 = 0;
+    for (int i = 0; i < 400; ++i) {
+        Move move = book.probe(board, rng);
+        ASSERT_TRUE(move == Move(E2, E4) || move == Move(D2, D4));
+        e4 += move == Move(E2, E4);
+    }
+    EXPECT_GT(e4, 250);
+    EXPECT_LT(e4, 350);
+
+    // Out of book
+    play({"g1f3"});
+    EXPECT_FALSE(book.probe(board, rng).isValid());
+}
+
+TEST_F(BookTest, DecodesCastling) {
+    ASSERT_TRUE(board.setFromFen("r3k2r/pppppppp/8/8/8/8/PPPPPPPP/R3K2R w KQkq - 0 1"));
+    writeBook({{Polyglot::key(board), encode(E1, H1), 1}});
+    ASSERT_TRUE(book.open(BOOK_FILE));
+
+    std::mt19937 rng(1);
+    EXPECT_EQ(book.probe(board, rng), Move(E1, G1));
+}
+
+TEST_F(BookTest, MissingFileIsRejected) {
+    EXPECT_FALSE(book.open("no_such_book.bin"));
+    EXPECT_FALSE(book.isOpen());
+    std::mt19937 rng(1);
+    EXPECT_FALSE(book.probe(board, rng).isValid());
+}
+
+TEST_F(BookTest, IgnoresTrailingPartialEntry) {
+    HashKey start = Polyglot::key(board);
+    writeBook({{start, encode(E2, E4), 1}});
+    {
+        std::ofstream file(BOOK_FILE, std::ios::binary | std::ios::app);
+        file.write("partial", 7);
+    }
+    ASSERT_TRUE(book.open(BOOK_FILE));
+    EXPECT_EQ(book.size(), 1u);
+
+    // Reopening unmaps the whole file first
+    ASSERT_TRUE(book.open(BOOK_FILE));
+    std::mt19937 rng(1);
+    EXPECT_EQ(book.probe(board, rng), Move(E2, E4));
+}
@@ -1,6 +1,9 @@
 #include "gtest/gtest.h"
 #include "chess_rl.h"
+#include "bitbase.h"
 #include "board.h"
+#include <cstdio>
+#include <string>
 #include <vector>
 
 TEST(ChessRLTest, FeatureExtractor) {
@@ -81,6 +84,33 @@ TEST(ChessRLTest, RewardCalculation) {
     EXPECT_GT(rewardBlack, 0.0f);
 }
 
+TEST(ChessRLTest, RewardUsesBitbases) {
+    BitboardUtils::initBitboards();
+    Bitbases::clear();
+    for (const Bitbases::Ending& ending : Bitbases::endings()) {
+        if (ending.name.size() <= 3) {
+            std::vector<uint8_t> table;
+            ASSERT_TRUE(Bitbases::generate(ending, table, 2)) << ending.name;
+            Bitbases::add(ending, std::move(table));
+        }
+    }
+    ChessRLAgent agent;
+    Board board;
+
+    // The king on the sixth rank in front of its pawn wins: the exact result, not
+    // the small material reward
+    ASSERT_TRUE(board.setFromFen("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1"));
+    EXPECT_EQ(agent.calculateReward(board, WHITE), 1.0f);
+    EXPECT_EQ(agent.calculateReward(board, BLACK), -1.0f);
+
+    // A rook pawn can't win against a king in its corner
+    ASSERT_TRUE(board.setFromFen("k7/8/8/8/8/8/P7/1K6 w - - 0 1"));
+    EXPECT_EQ(agent.calculateReward(board, WHITE), 0.0f);
+    EXPECT_EQ(agent.calculateReward(board, BLACK), 0.0f);
+
+    Bitbases::clear();
+}
+
 TEST(ChessRLTest, TrainingBasics) {
     // Create an agent
     ChessRLAgent agent;
@@ -106,4 +136,16 @@ TEST(ChessRLTest, TrainingBasics) {
     // We don't have direct access to the exploration rate, so we can't test its value directly
     // But we can ensure that the operation doesn't crash
     SUCCEED();
-}
\ No newline at end of file
+}
+
+TEST(ChessRLTest, LoadRejectsNetworkForOtherInputs) {
+    std::string path = ::testing::TempDir() + "chess_rl_small_network.bin";
+    NeuralNetwork small({4, 2, 1});
+    ASSERT_TRUE(small.save(path));
+    EXPECT_EQ(loadValueNetwork(path), nullptr);
+    
+    NeuralNetwork full(valueNetworkTopology());
+    ASSERT_TRUE(full.save(path));
+    EXPECT_NE(loadValueNetwork(path), nullptr);
+    std::remove(path.c_str());
+}
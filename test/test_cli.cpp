@@ -0,0 +1,103 @@
+#include "cli.h"
+#include "bitboard.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class CliTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        BitboardUtils::initBitboards();
+    }
+
+    void TearDown() override {
+        std::remove(INPUT_FILE);
+    }
+
+    static void writeInput(const std::vector<std::string>& lines) {
+        std::ofstream file(INPUT_FILE);
+        for (const std::string& line : lines) {
+            file << line << "\n";
+        }
+    }
+
+    // Run a mode and return what it wrote to standard output, one string per line
+    static std::vector<std::string> run(std::vector<std::string> args) {
+        args.insert(args.begin(), "bitchess");
+        std::vector<char*> argv;
+        for (std::string& arg : args) {
+            argv.push_back(&arg[0]);
+        }
+
+        std::ostringstream captured;
+        std::streambuf* original = std::cout.rdbuf(captured.rdbuf());
+        int status = Cli::run(static_cast<int>(argv.size()), argv.data());
+        std::cout.rdbuf(original);
+        EXPECT_EQ(status, 0);
+
+        std::vector<std::string> lines;
+        std::istringstream output(captured.str());
+        for (std::string line; std::getline(output, line);) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    static constexpr const char* INPUT_FILE = "test_cli_input.epd";
+};
+
+TEST_F(CliTest, AnalyzeWritesRowsInInputOrder) {
+    const std::vector<std::string> fens = {
+        "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "R5k1/5ppp/8/8/8/8/8/6K1 b - - 1 1",
+        "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1",
+        "r5k1/8/8/8/8/8/5PPP/6K1 b - - 0 1",
+        "8/8/4k3/8/8/4K3/4P3/8 w - - 0 1",
+    };
+    writeInput(fens);
+
+    // More positions than workers, so they finish out of order
+    std::vector<std::string> lines = run({"analyze", INPUT_FILE, "depth", "3", "threads", "3"});
+    ASSERT_EQ(lines.size(), fens.size() + 1);
+    EXPECT_EQ(lines[0], "fen,id,bestmove,score,depth,nodes,time,pv");
+    for (size_t i = 0; i < fens.size(); ++i) {
+        EXPECT_EQ(lines[i + 1].compare(0, fens[i].size() + 1, fens[i] + ","), 0) << lines[i + 1];
+    }
+    EXPECT_EQ(lines[1].compare(fens[0].size(), 7, ",,a1a8,"), 0) << lines[1];
+    EXPECT_EQ(lines[5].compare(fens[4].size(), 7, ",,a8a1,"), 0) << lines[5];
+
+    // Checkmate and stalemate: no best move, mated or drawn
+    EXPECT_EQ(lines[3], fens[2] + ",,,#0,0,0,0,");
+    EXPECT_EQ(lines[4], fens[3] + ",,,0,0,0,0,");
+}
+
+TEST_F(CliTest, AnalyzeWritesFinishedGamesAsJson) {
+    writeInput({"R5k1/5ppp/8/8/8/8/8/6K1 b - - 1 1", "7k/5Q2/6K1/8/8/8/8/8 b - - 0 1"});
+
+    std::vector<std::string> lines = run({"analyze", INPUT_FILE, "depth", "2", "threads", "2", "format", "json"});
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0], "{\"fen\":\"R5k1/5ppp/8/8/8/8/8/6K1 b - - 1 1\",\"bestmove\":\"\",\"mate\":0,"
+                        "\"depth\":0,\"nodes\":0,\"time\":0,\"pv\":\"\"}");
+    EXPECT_EQ(lines[1], "{\"fen\":\"7k/5Q2/6K1/8/8/8/8/8 b - - 0 1\",\"bestmove\":\"\",\"cp\":0,"
+                        "\"depth\":0,\"nodes\":0,\"time\":0,\"pv\":\"\"}");
+}
+
+TEST_F(CliTest, SuiteReportsSolvedPositionsInOrder) {
+    writeInput({
+        "6k1/5ppp/8/8/8/8/8/R5K1 w - - bm Ra8#; id \"back rank\";",
+        "r5k1/8/8/8/8/8/5PPP/6K1 b - - bm Ra1#; id \"black back rank\";",
+        "6k1/5ppp/8/8/8/8/8/R5K1 w - - am Ra8; id \"avoid\";",
+    });
+
+    std::vector<std::string> lines = run({"suite", INPUT_FILE, "depth", "3", "threads", "2"});
+    ASSERT_GE(lines.size(), 4u);
+    EXPECT_EQ(lines[0].rfind("back rank: solved bm Ra8#, played a1a8 after ", 0), 0u) << lines[0];
+    EXPECT_EQ(lines[1].rfind("black back rank: solved bm Ra1#, played a8a1 after ", 0), 0u) << lines[1];
+    EXPECT_EQ(lines[2], "avoid: unsolved am Ra8, played a1a8");
+    EXPECT_EQ(lines[3], "Solved 2 of 3 (66%)");
+}
@@ -0,0 +1,65 @@
+#include "epd.h"
+#include <gtest/gtest.h>
+
+TEST(EpdTest, ParsesOperations) {
+    EpdRecord record;
+    ASSERT_TRUE(parseEpd("kbK5/pp6/1P6/8/8/8/8/R7 w - - bm Ra6; dm 2; id \"mate; quiet\";", record));
+    EXPECT_EQ(record.fen, "kbK5/pp6/1P6/8/8/8/8/R7 w - - 0 1");
+    ASSERT_EQ(record.operations.size(), 3u);
+    EXPECT_EQ(*record.operation("bm"), "Ra6");
+    EXPECT_EQ(*record.operation("dm"), "2");
+    EXPECT_EQ(*record.operation("id"), "mate; quiet");
+    EXPECT_EQ(record.operation("am"), nullptr);
+}
+
+TEST(EpdTest, ParsesFenCounters) {
+    EpdRecord record;
+    ASSERT_TRUE(parseEpd("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", record));
+    EXPECT_EQ(record.fen, "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+    EXPECT_TRUE(record.operations.empty());
+
+    ASSERT_TRUE(parseEpd("8/8/8/8/8/8/8/K1k5 w - - 12 40 c0 \"late\";", record));
+    EXPECT_EQ(record.fen, "8/8/8/8/8/8/8/K1k5 w - - 12 40");
+    EXPECT_EQ(*record.operation("c0"), "late");
+}
+
+TEST(EpdTest, SkipsBlankAndCommentLines) {
+    EpdRecord record;
+    EXPECT_FALSE(parseEpd("", record));
+    EXPECT_FALSE(parseEpd("   ", record));
+    EXPECT_FALSE(parseEpd("# puzzles", record));
+    EXPECT_FALSE(parseEpd("not a position", record));
+}
+
+TEST(EpdTest, ParsesSanMoves) {
+    BitboardUtils::initBitboards();
+    Board board;
+    ASSERT_TRUE(board.setFromFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"));
+
+    EXPECT_EQ(parseEpdMove(board, "Qxf6"), Move(F3, F6));
+    EXPECT_EQ(parseEpdMove(board, "dxe6!"), Move(D5, E6));
+    EXPECT_EQ(parseEpdMove(board, "Nxf7"), Move(E5, F7));
+    EXPECT_EQ(parseEpdMove(board, "O-O"), Move(E1, G1));
+    EXPECT_EQ(parseEpdMove(board, "O-O-O"), Move(E1, C1));
+    EXPECT_EQ(parseEpdMove(board, "gxh3"), Move(G2, H3));
+    EXPECT_EQ(parseEpdMove(board, "e2a6"), Move(E2, A6));
+
+    // An illegal or unknown move isn't found
+    EXPECT_FALSE(parseEpdMove(board, "Qh8").isValid());
+    EXPECT_FALSE(parseEpdMove(board, "xyz").isValid());
+
+    // Both knights reach b3
+    ASSERT_TRUE(board.setFromFen("4k3/8/8/8/8/8/8/N1N1K3 w - - 0 1"));
+    EXPECT_FALSE(parseEpdMove(board, "Nb3").isValid());
+    EXPECT_EQ(parseEpdMove(board, "Nab3"), Move(A1, B3));
+    EXPECT_EQ(parseEpdMove(board, "N1xb3"), Move());
+
+    ASSERT_TRUE(board.setFromFen("8/1P6/8/8/8/8/8/k1K5 w - - 0 1"));
+    EXPECT_EQ(parseEpdMove(board, "b8=N+"), Move(B7, B8, KNIGHT));
+    EXPECT_EQ(parseEpdMove(board, "b8Q"), Move(B7, B8, QUEEN));
+
+    std::vector<Move> moves;
+    EXPECT_TRUE(parseEpdMoves(board, "b8=Q b8=R", moves));
+    EXPECT_EQ(moves.size(), 2u);
+    EXPECT_FALSE(parseEpdMoves(board, "b8=Q Kb1", moves));
+}
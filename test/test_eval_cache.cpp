@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+#include "eval_cache.h"
+#include "chess_rl.h"
+#include <vector>
+#include <thread>
+
+TEST(EvalCacheTest, StoreAndProbe) {
+    EvalCache cache(1024);
+    EXPECT_EQ(cache.size(), 1024u);
+
+    float value = 0.0f;
+    EXPECT_FALSE(cache.probe(0x1234, 1, value));
+
+    cache.store(0x1234, 1, 0.75f);
+    EXPECT_TRUE(cache.probe(0x1234, 1, value));
+    EXPECT_FLOAT_EQ(value, 0.75f);
+
+    // A different model version or a colliding key misses
+    EXPECT_FALSE(cache.probe(0x1234, 2, value));
+    EXPECT_FALSE(cache.probe(0x1234 + 1024, 1, value));
+
+    EXPECT_EQ(cache.probes(), 4u);
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_DOUBLE_EQ(cache.hitRate(), 0.25);
+
+    cache.clear();
+    EXPECT_FALSE(cache.probe(0x1234, 1, value));
+}
+
+TEST(EvalCacheTest, ConcurrentWritersNeverReturnTornEntries) {
+    // Every key maps to the same handful of slots and always stores a value derived
+    // from itself, so any torn read would show up as a mismatching value
+    EvalCache cache(8);
+    const int threads = 4;
+    std::vector<std::thread> workers;
+    std::vector<int> errors(threads, 0);
+
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (uint64_t i = 0; i < 100000; i++) {
+                uint64_t key = (i * 0x9E3779B97F4A7C15ULL) ^ t;
+                cache.store(key, 7, static_cast<float>(key & 0xFFFF));
+
+                uint64_t probeKey = ((i / 2) * 0x9E3779B97F4A7C15ULL) ^ ((t + 1) % threads);
+                float value;
+                if (cache.probe(probeKey, 7, value) && value != static_cast<float>(probeKey & 0xFFFF)) {
+                    errors[t]++;
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (int t = 0; t < threads; t++) {
+        EXPECT_EQ(errors[t], 0);
+    }
+}
+
+TEST(EvalCacheTest, AgentReusesEvaluationsUntilTrained) {
+    ChessRLAgent agent(0.0f);
+    Board board;
+    board.reset();
+    std::vector<Move> legalMoves = board.generateLegalMoves();
+
+    // The second search of the same position is served entirely from the cache
+    Move first = agent.selectMove(board, legalMoves);
+    agent.evaluationCache().resetStats();
+    Move second = agent.selectMove(board, legalMoves);
+    EXPECT_EQ(first, second);
+    EXPECT_DOUBLE_EQ(agent.evaluationCache().hitRate(), 1.0);
+
+    // Training changes the weights, so the cached values no longer apply
+    agent.recordTransition(board, first, 0.0f);
+    Board next = board;
+    next.makeMove(first);
+    agent.recordTransition(next, next.generateLegalMoves()[0], 1.0f);
+    agent.train(2);
+
+    agent.evaluationCache().resetStats();
+    agent.selectMove(board, legalMoves);
+    EXPECT_EQ(agent.evaluationCache().hits(), 0u);
+}
+
+TEST(EvalCacheTest, HalfmoveClockIsPartOfTheKey) {
+    // The network sees the halfmove clock, so positions differing only in it are cached apart
+    ChessRLAgent agent(0.0f);
+    Board fresh;
+    Board aged;
+    ASSERT_TRUE(fresh.setFromFen("4k3/8/8/8/8/8/8/R3K3 w Q - 0 1"));
+    ASSERT_TRUE(aged.setFromFen("4k3/8/8/8/8/8/8/R3K3 w Q - 40 1"));
+    ASSERT_EQ(fresh.hash(), aged.hash());
+
+    agent.selectMove(fresh, fresh.generateLegalMoves());
+    agent.evaluationCache().resetStats();
+    agent.selectMove(aged, aged.generateLegalMoves());
+    EXPECT_GT(agent.evaluationCache().probes(), 0u);
+    EXPECT_EQ(agent.evaluationCache().hits(), 0u);
+}
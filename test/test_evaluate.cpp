@@ -0,0 +1,77 @@
+#include "evaluate.h"
+#include "board.h"
+#include <gtest/gtest.h>
+#include <string>
+
+class EvaluateTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        BitboardUtils::initBitboards();
+        board.reset();
+    }
+
+    // Check that the incrementally updated score matches a full recomputation
+    void expectConsistent() {
+        Eval::Score psqt;
+        int phase;
+        Eval::computePsqt(board, psqt, phase);
+        EXPECT_EQ(board._psqt, psqt);
+        EXPECT_EQ(board._phase, phase);
+    }
+
+    int evaluateFen(const std::string& fen) {
+        EXPECT_TRUE(board.setFromFen(fen));
+        return Eval::evaluate(board);
+    }
+
+    Board board;
+};
+
+TEST_F(EvaluateTest, StartPositionIsBalanced) {
+    expectConsistent();
+    EXPECT_EQ(board._phase, Eval::PHASE_MAX);
+    EXPECT_EQ(board._psqt, Eval::Score());
+
+    // Only the side to move bonus remains
+    int white = Eval::evaluate(board);
+    board.makeNullMove();
+    EXPECT_EQ(Eval::evaluate(board), white);
+}
+
+TEST_F(EvaluateTest, IncrementalUpdateMatchesRecomputation) {
+    // Castling, en passant, captures and a promotion
+    const std::string fen = "r3k2r/1P6/8/8/4p3/8/3P1P2/R3K2R w KQkq - 0 1";
+    ASSERT_TRUE(board.setFromFen(fen));
+    const Move moves[] = {
+        Move(D2, D4), Move(E4, D3), Move(E1, G1), Move(E8, G8),
+        Move(B7, B8, QUEEN), Move(A8, B8)
+    };
+    for (const Move& move : moves) {
+        ASSERT_TRUE(board.makeMove(move)) << move.toUci();
+        expectConsistent();
+    }
+}
+
+TEST_F(EvaluateTest, MirroredPositionsScoreTheSame) {
+    // The same position with colors swapped scores the same for the side to move
+    int white = evaluateFen("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4");
+    int black = evaluateFen("rnbqk2r/pppp1ppp/5n2/2b1p3/4P3/2N2N2/PPPP1PPP/R1BQKB1R b KQkq - 4 4");
+    EXPECT_EQ(white, black);
+}
+
+TEST_F(EvaluateTest, MaterialAdvantage) {
+    EXPECT_GT(evaluateFen("4k3/8/8/8/8/8/8/3QK3 w - - 0 1"), 800);
+    EXPECT_LT(evaluateFen("4k3/8/8/8/8/8/8/3QK3 b - - 0 1"), -800);
+}
+
+TEST_F(EvaluateTest, PawnStructure) {
+    // White's d-pawn is passed when the black pawn is on a7, but not when it is on c7
+    int passed = evaluateFen("4k3/p7/8/3P4/8/8/8/4K3 w - - 0 1");
+    int stopped = evaluateFen("4k3/2p5/8/3P4/8/8/8/4K3 w - - 0 1");
+    EXPECT_GT(passed, stopped);
+
+    // Doubled isolated pawns are worth less than two connected ones
+    int doubled = evaluateFen("4k3/8/8/8/8/3P4/3P4/4K3 w - - 0 1");
+    int connected = evaluateFen("4k3/8/8/8/8/8/3PP3/4K3 w - - 0 1");
+    EXPECT_LT(doubled, connected);
+}
@@ -0,0 +1,82 @@
+#include "mate.h"
+#include "engine.h"
+#include "board.h"
+#include <gtest/gtest.h>
+#include <string>
+
+class MateTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        BitboardUtils::initBitboards();
+    }
+
+    MateResult solveFen(const std::string& fen, int maxMoves, const SearchLimits& limits = SearchLimits()) {
+        EXPECT_TRUE(board.setFromFen(fen));
+        return solver.solve(board, maxMoves, limits);
+    }
+
+    Board board;
+    MateSolver solver{1};
+};
+
+TEST_F(MateTest, FindsMateInOne) {
+    MateResult result = solveFen("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", 3);
+    ASSERT_TRUE(result.found);
+    EXPECT_EQ(result.moves, 1);
+    ASSERT_EQ(result.pv.size(), 1u);
+    EXPECT_EQ(result.pv[0], Move(A1, A8));
+}
+
+TEST_F(MateTest, FindsMateInTwoWithQuietSacrifice) {
+    // 1. Ra6 bxa6 (or anything else) 2. b7#
+    MateResult result = solveFen("kbK5/pp6/1P6/8/8/8/8/R7 w - - 0 1", 3);
+    ASSERT_TRUE(result.found);
+    EXPECT_EQ(result.moves, 2);
+    ASSERT_EQ(result.pv.size(), 3u);
+    EXPECT_EQ(result.pv[0], Move(A1, A6));
+
+    // The line ends in mate
+    Board position = board;
+    for (const Move& move : result.pv) {
+        ASSERT_TRUE(position.makeMove(move));
+    }
+    EXPECT_TRUE(position.isCheckmate());
+}
+
+TEST_F(MateTest, FindsMateForBlack) {
+    MateResult result = solveFen("r5k1/8/8/8/8/8/5PPP/6K1 b - - 0 1", 2);
+    ASSERT_TRUE(result.found);
+    EXPECT_EQ(result.moves, 1);
+    EXPECT_EQ(result.pv[0], Move(A8, A1));
+}
+
+TEST_F(MateTest, DisprovesMissingMate) {
+    board.reset();
+    MateResult result = solver.solve(board, 2);
+    EXPECT_FALSE(result.found);
+    EXPECT_TRUE(result.disproven);
+}
+
+TEST_F(MateTest, StopsAtNodeLimit) {
+    SearchLimits limits;
+    limits.nodes = 50;
+    MateResult result = solveFen("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 0 1", 4, limits);
+    EXPECT_FALSE(result.found);
+    EXPECT_FALSE(result.disproven);
+    EXPECT_LE(result.nodes, 51u);
+}
+
+TEST_F(MateTest, EngineAnswersGoMate) {
+    Engine engine;
+    engine.useSearch();
+    ASSERT_TRUE(board.setFromFen("kbK5/pp6/1P6/8/8/8/8/R7 w - - 0 1"));
+    engine.setPosition(board);
+
+    SearchInfo reported;
+    engine.setInfoCallback([&](const SearchInfo& info) { reported = info; });
+
+    SearchLimits limits;
+    limits.mate = 2;
+    EXPECT_EQ(engine.makeMove(limits), Move(A1, A6));
+    EXPECT_EQ(reported.score, VALUE_MATE - 3);
+}
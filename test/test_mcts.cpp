@@ -0,0 +1,137 @@
+#include "mcts.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+class MCTSTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        BitboardUtils::initBitboards();
+        board.reset();
+    }
+
+    // Search a position with a fixed number of visits
+    SearchResult searchFen(const std::string& fen, uint64_t visits) {
+        EXPECT_TRUE(board.setFromFen(fen));
+        SearchLimits limits;
+        limits.nodes = visits;
+        return mcts.run(board, limits);
+    }
+
+    Board board;
+    MCTS mcts;
+};
+
+TEST_F(MCTSTest, ReturnsLegalMove) {
+    SearchLimits limits;
+    limits.nodes = 200;
+    SearchResult result = mcts.run(board, limits);
+
+    std::vector<Move> legalMoves = board.generateLegalMoves();
+    EXPECT_NE(std::find(legalMoves.begin(), legalMoves.end(), result.bestMove), legalMoves.end());
+    EXPECT_TRUE(result.ponderMove.isValid());
+    EXPECT_GE(result.nodes, 200u);
+}
+
+TEST_F(MCTSTest, FindsMateInOne) {
+    SearchResult result = searchFen("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1", 400);
+    EXPECT_EQ(result.bestMove, Move(D1, D8));
+    EXPECT_EQ(result.score, VALUE_MATE - 1);
+}
+
+TEST_F(MCTSTest, CapturesHangingQueen) {
+    SearchResult result = searchFen("4k3/8/8/3q4/4P3/8/8/4K3 w - - 0 1", 400);
+    EXPECT_EQ(result.bestMove, Move(E4, D5));
+    EXPECT_GT(result.score, 0);
+}
+
+TEST_F(MCTSTest, NoLegalMoves) {
+    SearchResult result = searchFen("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3", 100);
+    EXPECT_FALSE(result.bestMove.isValid());
+}
+
+TEST_F(MCTSTest, SharedTreeRespectsVisitBudget) {
+    // Every worker may finish the simulation it started when the budget ran out
+    mcts.options().threads = 4;
+    SearchResult result = searchFen("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3", 2000);
+    EXPECT_GE(result.nodes, 2000u);
+    EXPECT_LT(result.nodes, 2000u + 4);
+    EXPECT_TRUE(result.bestMove.isValid());
+}
+
+TEST_F(MCTSTest, StopFromAnotherThread) {
+    SearchLimits limits;
+    limits.infinite = true;
+    mcts.options().threads = 2;
+
+    std::thread stopper([this]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        mcts.stop();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    SearchResult result = mcts.run(board, limits);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    stopper.join();
+
+    EXPECT_TRUE(result.bestMove.isValid());
+    EXPECT_LT(elapsed, 2000);
+}
+
+TEST_F(MCTSTest, MoveTimeLimit) {
+    SearchLimits limits;
+    limits.moveTime = 100;
+
+    auto start = std::chrono::steady_clock::now();
+    SearchResult result = mcts.run(board, limits);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_TRUE(result.bestMove.isValid());
+    EXPECT_LT(elapsed, 1000);
+}
+
+TEST_F(MCTSTest, ReusesSubtreeAfterTwoPlies) {
+    SearchLimits limits;
+    limits.nodes = 2000;
+    SearchResult first = mcts.run(board, limits);
+    ASSERT_TRUE(first.ponderMove.isValid());
+
+    // Our move and the expected reply lead to a node the tree has already visited
+    ASSERT_TRUE(board.makeMove(first.bestMove));
+    ASSERT_TRUE(board.makeMove(first.ponderMove));
+
+    limits.nodes = 100;
+    mcts.run(board, limits);
+    EXPECT_GT(mcts.root()->visits.load(), 100u);
+
+    // Without reuse the tree starts empty
+    mcts.options().reuseTree = false;
+    mcts.run(board, limits);
+    EXPECT_EQ(mcts.root()->visits.load(), 100u);
+}
+
+TEST_F(MCTSTest, TreeSizeLimitStopsInfiniteSearch) {
+    // Without a cap an infinite search would grow until stopped
+    mcts.options().maxNodes = 2000;
+    SearchLimits limits;
+    limits.infinite = true;
+    SearchResult result = mcts.run(board, limits);
+
+    EXPECT_TRUE(result.bestMove.isValid());
+    EXPECT_LE(mcts.treeNodes(), 2000u);
+    EXPECT_GT(mcts.treeNodes(), 1000u);
+}
+
+TEST_F(MCTSTest, PonderRespectsNodeLimit) {
+    SearchLimits limits;
+    limits.ponder = true;
+    limits.nodes = 300;
+    SearchResult result = mcts.run(board, limits);
+
+    EXPECT_GE(result.nodes, 300u);
+    EXPECT_LT(result.nodes, 300u + 64);
+}
@@ -67,4 +67,38 @@ TEST(NeuralNetworkTest, SaveAndLoad) {
     
     // Outputs should be identical
     EXPECT_FLOAT_EQ(outputOriginal, outputLoaded);
-}
\ No newline at end of file
+}
+
+TEST(NeuralNetworkTest, EvaluateMatchesForward) {
+    std::vector<int> topology = {4, 8, 3, 1};
+    NeuralNetwork network(topology);
+    
+    std::vector<std::vector<float>> inputs = {
+        {0.5f, -0.5f, 1.0f, 0.0f},
+        {0.0f, 0.0f, 0.0f, 0.0f},
+        {-1.0f, 0.25f, 0.75f, 1.0f}
+    };
+    
+    // The const and batched passes must agree with the training forward pass
+    std::vector<float> batched = network.evaluateBatch(inputs);
+    ASSERT_EQ(batched.size(), inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+        float expected = network.forward(inputs[i]);
+        EXPECT_NEAR(network.evaluate(inputs[i]), expected, 1e-5f);
+        EXPECT_NEAR(batched[i], expected, 1e-5f);
+    }
+}
+
+TEST(NeuralNetworkTest, FirstLayerColumnsFollowTraining) {
+    std::vector<int> topology = {4, 8, 3, 1};
+    NeuralNetwork network(topology);
+    std::vector<float> input = {0.5f, -0.5f, 1.0f, 0.0f};
+    
+    // Pre-activations summed column by column must see the weights backpropagation changed
+    network.backpropagate(input, 1.0f, 0.1f);
+    std::vector<float> preActivations = network.firstLayerBiases();
+    for (size_t j = 0; j < input.size(); j++) {
+        network.addFirstLayerColumn(preActivations, j, input[j]);
+    }
+    EXPECT_NEAR(network.evaluateFromFirstLayer(preActivations), network.evaluate(input), 1e-5f);
+}
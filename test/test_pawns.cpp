@@ -0,0 +1,71 @@
+#include "pawns.h"
+#include "board.h"
+#include <gtest/gtest.h>
+#include <string>
+
+class PawnsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        BitboardUtils::initBitboards();
+        board.reset();
+    }
+
+    const Pawns::Entry& probeFen(const std::string& fen) {
+        EXPECT_TRUE(board.setFromFen(fen));
+        return table.probe(board);
+    }
+
+    Board board;
+    Pawns::Table table;
+};
+
+TEST_F(PawnsTest, PawnKeyOnlyChangesWithPawns) {
+    HashKey start = board.pawnHash();
+    EXPECT_EQ(start, Zobrist::computePawnKey(board));
+
+    // Piece moves leave the pawn structure alone
+    ASSERT_TRUE(board.makeMove(Move(G1, F3)));
+    ASSERT_TRUE(board.makeMove(Move(G8, F6)));
+    EXPECT_EQ(board.pawnHash(), start);
+
+    ASSERT_TRUE(board.makeMove(Move(E2, E4)));
+    EXPECT_NE(board.pawnHash(), start);
+    EXPECT_EQ(board.pawnHash(), Zobrist::computePawnKey(board));
+}
+
+TEST_F(PawnsTest, CachesStructures) {
+    table.probe(board);
+    EXPECT_EQ(table.hits(), 0u);
+
+    // Same pawns after piece moves: served from the table
+    ASSERT_TRUE(board.makeMove(Move(B1, C3)));
+    table.probe(board);
+    EXPECT_EQ(table.hits(), 1u);
+    EXPECT_EQ(table.probes(), 2u);
+}
+
+TEST_F(PawnsTest, PassedPawns) {
+    // d5 is passed, e4 is held back by the f6 pawn, a7 is passed for Black
+    ASSERT_TRUE(board.setFromFen("4k3/p7/5p2/3P4/4P3/8/8/4K3 w - - 0 1"));
+    EXPECT_EQ(Pawns::passed(board, WHITE), 1ULL << D5);
+    EXPECT_EQ(Pawns::passed(board, BLACK), 1ULL << A7);
+}
+
+TEST_F(PawnsTest, BackwardPawns) {
+    // d3 can't be defended by the c4 and e4 pawns and the c5 pawn attacks d4
+    ASSERT_TRUE(board.setFromFen("4k3/8/8/2p5/2P1P3/3P4/8/4K3 w - - 0 1"));
+    EXPECT_EQ(Pawns::backward(board, WHITE), 1ULL << D3);
+    EXPECT_EQ(Pawns::backward(board, BLACK), 0ULL);
+
+    // It is only weak, not backward, when nothing attacks its stop square
+    ASSERT_TRUE(board.setFromFen("4k3/8/2p5/8/2P1P3/3P4/8/4K3 w - - 0 1"));
+    EXPECT_EQ(Pawns::backward(board, WHITE), 0ULL);
+}
+
+TEST_F(PawnsTest, KingShelter) {
+    // Intact kingside shield against one with the g-pawn pushed and the h-pawn gone
+    const Pawns::Entry& intact = probeFen("4k3/8/8/8/8/8/5PPP/6K1 w - - 0 1");
+    Eval::Score intactShelter = intact.shelter[WHITE][FILE_G];
+    const Pawns::Entry& weakened = probeFen("4k3/8/8/8/8/6P1/5P2/6K1 w - - 0 1");
+    EXPECT_GT(intactShelter.mg, weakened.shelter[WHITE][FILE_G].mg);
+}
@@ -0,0 +1,313 @@
+#include "search.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+class SearchTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        BitboardUtils::initBitboards();
+        board.reset();
+    }
+    
+    // Search a position to a fixed depth
+    SearchResult searchFen(const std::string& fen, int depth) {
+        EXPECT_TRUE(board.setFromFen(fen));
+        SearchLimits limits;
+        limits.depth = depth;
+        return search.run(board, limits);
+    }
+    
+    Board board;
+    Search search;
+};
+
+TEST_F(SearchTest, FindsMateInOne) {
+    // Back rank mate with Rd8#
+    SearchResult result = searchFen("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1", 4);
+    EXPECT_EQ(result.bestMove, Move(D1, D8));
+    EXPECT_EQ(result.score, VALUE_MATE - 1);
+}
+
+TEST_F(SearchTest, CapturesHangingQueen) {
+    SearchResult result = searchFen("4k3/8/8/3q4/4P3/8/8/4K3 w - - 0 1", 4);
+    EXPECT_EQ(result.bestMove, Move(E4, D5));
+    EXPECT_GT(result.score, 0);
+}
+
+TEST_F(SearchTest, NoLegalMoves) {
+    // Checkmated side has no move to return
+    SearchResult result = searchFen("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3", 3);
+    EXPECT_FALSE(result.bestMove.isValid());
+}
+
+TEST_F(SearchTest, SelectiveSearchFindsSameMate) {
+    // Mate in two: 1. Rd8+ Rxd8 2. Rxd8#
+    const std::string fen = "2r3k1/5ppp/8/8/8/8/3R1PPP/3R2K1 w - - 0 1";
+    
+    SearchResult selective = searchFen(fen, 5);
+    
+    search.options() = SearchOptions{false, false, false, false};
+    search.clear();
+    SearchResult full = searchFen(fen, 5);
+    
+    EXPECT_EQ(selective.score, VALUE_MATE - 3);
+    EXPECT_EQ(full.score, VALUE_MATE - 3);
+}
+
+TEST_F(SearchTest, SelectiveSearchReducesNodes) {
+    const std::string fen = "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3";
+    
+    SearchResult selective = searchFen(fen, 5);
+    
+    search.options() = SearchOptions{false, false, false, false};
+    search.clear();
+    SearchResult full = searchFen(fen, 5);
+    
+    EXPECT_LT(selective.nodes, full.nodes);
+}
+
+TEST_F(SearchTest, ReportsBranchingFactor) {
+    std::vector<SearchInfo> reports;
+    search.setInfoCallback([&reports](const SearchInfo& info) { reports.push_back(info); });
+    
+    SearchResult result = searchFen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4);
+    
+    ASSERT_EQ(reports.size(), 4u);
+    EXPECT_EQ(reports[0].branchingFactor, 0.0);
+    for (size_t i = 1; i < reports.size(); ++i) {
+        EXPECT_EQ(reports[i].depth, static_cast<int>(i + 1));
+        EXPECT_GT(reports[i].branchingFactor, 0.0);
+    }
+    ASSERT_FALSE(reports.back().pv.empty());
+    EXPECT_EQ(reports.back().pv.front(), result.bestMove);
+}
+
+TEST_F(SearchTest, MultiPvReportsDistinctLines) {
+    std::vector<SearchInfo> reports;
+    search.setInfoCallback([&reports](const SearchInfo& info) { reports.push_back(info); });
+    search.setMultiPv(3);
+    
+    // Only capturing the queen wins, the other lines are ranked below it
+    SearchResult result = searchFen("4k3/8/8/3q4/4P3/8/8/4K3 w - - 0 1", 4);
+    EXPECT_EQ(result.bestMove, Move(E4, D5));
+    
+    ASSERT_EQ(reports.size(), 12u);
+    std::vector<SearchInfo> last(reports.end() - 3, reports.end());
+    for (int line = 0; line < 3; ++line) {
+        EXPECT_EQ(last[line].depth, 4);
+        EXPECT_EQ(last[line].multiPv, line + 1);
+        ASSERT_FALSE(last[line].pv.empty());
+    }
+    EXPECT_EQ(last[0].pv[0], result.bestMove);
+    EXPECT_EQ(last[0].score, result.score);
+    EXPECT_FALSE(last[0].pv[0] == last[1].pv[0]);
+    EXPECT_FALSE(last[1].pv[0] == last[2].pv[0]);
+    EXPECT_FALSE(last[0].pv[0] == last[2].pv[0]);
+    EXPECT_GT(last[0].score, last[1].score);
+    EXPECT_GE(last[1].score, last[2].score);
+}
+
+TEST_F(SearchTest, MultiPvIsLimitedToLegalMoves) {
+    search.setMultiPv(10);
+    
+    // The king's only move is Kb8
+    std::vector<SearchInfo> reports;
+    search.setInfoCallback([&reports](const SearchInfo& info) { reports.push_back(info); });
+    SearchResult result = searchFen("k7/8/1K6/8/8/8/8/8 b - - 0 1", 2);
+    EXPECT_EQ(result.bestMove, Move(A8, B8));
+    ASSERT_EQ(reports.size(), 2u);
+    EXPECT_EQ(reports.back().multiPv, 1);
+}
+
+TEST_F(SearchTest, ReportsTableUsage) {
+    std::vector<SearchInfo> reports;
+    search.setInfoCallback([&reports](const SearchInfo& info) { reports.push_back(info); });
+    search.setHashSize(1);
+    
+    searchFen("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3", 7);
+    
+    ASSERT_FALSE(reports.empty());
+    for (const SearchInfo& info : reports) {
+        if (!info.progress) {
+            EXPECT_EQ(info.multiPv, 1);
+        }
+        EXPECT_GE(info.hashfull, 0);
+        EXPECT_LE(info.hashfull, 1000);
+    }
+    EXPECT_GT(reports.back().hashfull, 0);
+}
+
+TEST_F(SearchTest, AspirationWindowsKeepBestMove) {
+    // Knight fork winning the queen: 1. Nc7+
+    const std::string fen = "r3k3/8/8/1N1q4/8/8/8/4K3 w - - 0 1";
+    
+    SearchResult withWindows = searchFen(fen, 6);
+    
+    search.options().aspirationWindows = false;
+    search.clear();
+    SearchResult withoutWindows = searchFen(fen, 6);
+    
+    EXPECT_EQ(withWindows.bestMove, Move(B5, C7));
+    EXPECT_EQ(withoutWindows.bestMove, Move(B5, C7));
+}
+
+TEST_F(SearchTest, NodeLimit) {
+    EXPECT_TRUE(board.setFromFen("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3"));
+    SearchLimits limits;
+    limits.nodes = 5000;
+    SearchResult result = search.run(board, limits);
+    
+    EXPECT_TRUE(result.bestMove.isValid());
+    EXPECT_LE(result.nodes, limits.nodes + 1);
+}
+
+TEST_F(SearchTest, MoveTimeLimit) {
+    SearchLimits limits;
+    limits.moveTime = 200;
+    auto start = std::chrono::steady_clock::now();
+    SearchResult result = search.run(board, limits);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    
+    EXPECT_TRUE(result.bestMove.isValid());
+    EXPECT_LE(elapsed, 200 + 100);
+}
+
+TEST_F(SearchTest, MateLimitStopsAtMate) {
+    EXPECT_TRUE(board.setFromFen("2r3k1/5ppp/8/8/8/8/3R1PPP/3R2K1 w - - 0 1"));
+    SearchLimits limits;
+    limits.mate = 2;
+    SearchResult result = search.run(board, limits);
+    
+    EXPECT_EQ(result.bestMove, Move(D2, D8));
+    EXPECT_EQ(result.score, VALUE_MATE - 3);
+    EXPECT_LE(result.depth, 3);
+}
+
+TEST(TimeManagerTest, SuddenDeathAllocation) {
+    SearchLimits limits;
+    limits.time[WHITE] = 60000;
+    limits.time[BLACK] = 1000;
+    
+    TimeManager timeManager;
+    timeManager.setMoveOverhead(0);
+    timeManager.start(limits, WHITE);
+    EXPECT_TRUE(timeManager.isTimed());
+    EXPECT_EQ(timeManager.softLimit(), 2000);
+    EXPECT_EQ(timeManager.hardLimit(), 8000);
+    
+    // Black has much less time left
+    timeManager.start(limits, BLACK);
+    EXPECT_LT(timeManager.hardLimit(), 1000);
+    EXPECT_LE(timeManager.softLimit(), timeManager.hardLimit());
+}
+
+TEST(TimeManagerTest, LastMoveBeforeTimeControl) {
+    SearchLimits limits;
+    limits.time[WHITE] = 10000;
+    limits.increment[WHITE] = 1000;
+    limits.movesToGo = 1;
+    
+    TimeManager timeManager;
+    timeManager.setMoveOverhead(50);
+    timeManager.start(limits, WHITE);
+    
+    // Never use the whole clock, even with one move to go
+    EXPECT_LT(timeManager.hardLimit(), 10000 - 50);
+    EXPECT_LE(timeManager.softLimit(), timeManager.hardLimit());
+}
+
+TEST(TimeManagerTest, InfiniteAndMoveTime) {
+    SearchLimits limits;
+    limits.time[WHITE] = 10000;
+    limits.infinite = true;
+    
+    TimeManager timeManager;
+    timeManager.start(limits, WHITE);
+    EXPECT_FALSE(timeManager.isTimed());
+    
+    limits.infinite = false;
+    limits.moveTime = 500;
+    timeManager.setMoveOverhead(0);
+    timeManager.start(limits, WHITE);
+    EXPECT_EQ(timeManager.softLimit(), 500);
+    EXPECT_EQ(timeManager.hardLimit(), 500);
+}
+
+TEST_F(SearchTest, StopFromAnotherThread) {
+    SearchLimits limits;
+    limits.infinite = true;
+    
+    SearchResult result;
+    std::thread searchThread([&]() { result = search.run(board, limits); });
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto stopTime = std::chrono::steady_clock::now();
+    search.stop();
+    searchThread.join();
+    auto stopLatency = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - stopTime).count();
+    
+    EXPECT_TRUE(result.bestMove.isValid());
+    EXPECT_LT(stopLatency, 50);
+    
+    // A new search runs normally once the request is cleared
+    search.clearRequests();
+    limits.infinite = false;
+    limits.depth = 3;
+    result = search.run(board, limits);
+    EXPECT_EQ(result.depth, 3);
+}
+
+TEST_F(SearchTest, PonderhitStartsClock) {
+    SearchLimits limits;
+    limits.ponder = true;
+    limits.moveTime = 100;
+    
+    SearchResult result;
+    std::thread searchThread([&]() { result = search.run(board, limits); });
+    
+    // While pondering, the move time doesn't apply
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    auto ponderhitTime = std::chrono::steady_clock::now();
+    search.ponderhit();
+    searchThread.join();
+    auto afterPonderhit = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - ponderhitTime).count();
+    
+    EXPECT_TRUE(result.bestMove.isValid());
+    EXPECT_LE(afterPonderhit, 100 + 100);
+}
+
+TEST_F(SearchTest, ReportsPonderMove) {
+    SearchResult result = searchFen("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3", 5);
+    ASSERT_TRUE(result.bestMove.isValid());
+    ASSERT_TRUE(result.ponderMove.isValid());
+    
+    Board next = board;
+    EXPECT_TRUE(next.makeMove(result.bestMove));
+    EXPECT_TRUE(next.makeMove(result.ponderMove));
+}
+
+TEST_F(SearchTest, RepetitionOfGamePositionIsDraw) {
+    // White's only move, Kg1, returns to a position played earlier in the game
+    ASSERT_TRUE(board.setFromFen("1q6/8/8/8/8/5k2/r7/6K1 b - - 7 49"));
+    std::vector<HashKey> history;
+    for (const char* uci : {"a2a3", "g1h1", "a3a2"}) {
+        history.push_back(board.hash());
+        ASSERT_TRUE(board.makeMove(Move::fromUci(uci)));
+    }
+
+    SearchLimits limits;
+    limits.depth = 3;
+    EXPECT_LT(search.run(board, limits).score, -500);
+
+    search.clear();
+    search.setGameHistory(history);
+    SearchResult result = search.run(board, limits);
+    EXPECT_EQ(result.bestMove, Move(H1, G1));
+    EXPECT_EQ(result.score, VALUE_DRAW);
+}
@@ -0,0 +1,133 @@
+#include "server.h"
+#include "bitboard.h"
+#include <gtest/gtest.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstring>
+#include <string>
+#include <thread>
+
+class ServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        BitboardUtils::initBitboards();
+        socketPath = "/tmp/bitchess_test_" + std::to_string(::getpid()) + ".sock";
+    }
+
+    // Connect a client to the server's socket
+    int connectClient() {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        EXPECT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+        return fd;
+    }
+
+    static void sendLine(int fd, const std::string& line) {
+        std::string text = line + "\n";
+        ASSERT_EQ(::send(fd, text.data(), text.size(), 0), static_cast<ssize_t>(text.size()));
+    }
+
+    // Read from the connection until the text appears (empty on timeout or close)
+    static std::string readUntil(int fd, const std::string& text) {
+        std::string received;
+        while (received.find(text) == std::string::npos) {
+            pollfd readable{fd, POLLIN, 0};
+            char buffer[1024];
+            ssize_t count = ::poll(&readable, 1, 10000) > 0 ? ::recv(fd, buffer, sizeof(buffer), 0) : 0;
+            if (count <= 0) {
+                return "";
+            }
+            received.append(buffer, static_cast<size_t>(count));
+        }
+        return received;
+    }
+
+    std::string socketPath;
+};
+
+TEST_F(ServerTest, ServesConcurrentSessions) {
+    Server server(2);
+    ASSERT_TRUE(server.listen("unix:" + socketPath));
+    std::thread acceptor(&Server::run, &server);
+
+    int first = connectClient();
+    int second = connectClient();
+    sendLine(first, "isready");
+    EXPECT_NE(readUntil(first, "readyok"), "");
+
+    // The bitbases are shared by every session
+    sendLine(first, "setoption name BitbasePath value /tmp");
+    EXPECT_NE(readUntil(first, "can't be changed"), "");
+
+    // Each session has its own position
+    sendLine(first, "setoption name Strategy value AlphaBeta");
+    sendLine(second, "setoption name Strategy value AlphaBeta");
+    sendLine(first, "position fen 6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    sendLine(second, "position fen r5k1/8/8/8/8/8/5PPP/6K1 b - - 0 1");
+    sendLine(first, "go depth 3");
+    sendLine(second, "go depth 3");
+    EXPECT_NE(readUntil(first, "bestmove a1a8"), "");
+    EXPECT_NE(readUntil(second, "bestmove a8a1"), "");
+    EXPECT_EQ(server.sessionCount(), 2u);
+
+    // quit ends only that session
+    sendLine(first, "quit");
+    EXPECT_EQ(readUntil(first, "never sent"), "");
+    ::close(first);
+    sendLine(second, "isready");
+    EXPECT_NE(readUntil(second, "readyok"), "");
+
+    // Stopping closes the remaining session
+    server.stop();
+    acceptor.join();
+    EXPECT_EQ(readUntil(second, "never sent"), "");
+    ::close(second);
+}
+
+TEST_F(ServerTest, ServesMoreSessionsThanSearchThreads) {
+    Server server(1);
+    ASSERT_TRUE(server.listen("unix:" + socketPath));
+    std::thread acceptor(&Server::run, &server);
+
+    int first = connectClient();
+    int second = connectClient();
+    sendLine(first, "setoption name Strategy value AlphaBeta");
+    sendLine(second, "setoption name Strategy value AlphaBeta");
+    sendLine(first, "position fen 6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    sendLine(second, "position fen r5k1/8/8/8/8/8/5PPP/6K1 b - - 0 1");
+
+    // A finished ponder search gives its worker back while its move waits for ponderhit
+    sendLine(first, "go ponder depth 2");
+    sendLine(second, "go depth 3");
+    EXPECT_NE(readUntil(second, "bestmove a8a1"), "");
+    sendLine(first, "ponderhit");
+    EXPECT_NE(readUntil(first, "bestmove a1a8"), "");
+
+    // With the only worker searching without a limit, a queued search is answered on stop
+    sendLine(first, "position startpos");
+    sendLine(first, "go infinite");
+    EXPECT_NE(readUntil(first, "info depth"), "");
+    sendLine(second, "position fen r5k1/8/8/8/8/8/5PPP/6K1 b - - 0 1");
+    sendLine(second, "go depth 3");
+    sendLine(second, "stop");
+    EXPECT_NE(readUntil(second, "bestmove a8a1"), "");
+    sendLine(second, "isready");
+    EXPECT_NE(readUntil(second, "readyok"), "");
+    sendLine(first, "stop");
+    EXPECT_NE(readUntil(first, "bestmove"), "");
+
+    server.stop();
+    acceptor.join();
+    ::close(first);
+    ::close(second);
+}
+
+TEST_F(ServerTest, RejectsInvalidAddresses) {
+    Server server(1);
+    EXPECT_FALSE(server.listen("not-a-port"));
+    EXPECT_FALSE(server.listen("localhost:70000"));
+}
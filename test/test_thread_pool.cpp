@@ -0,0 +1,31 @@
+#include "thread_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+
+TEST(ThreadPoolTest, RunsEveryTask) {
+    std::atomic<int> sum(0);
+    std::vector<std::future<void>> done;
+    {
+        ThreadPool pool(3);
+        EXPECT_EQ(pool.size(), 3u);
+        for (int i = 1; i <= 100; ++i) {
+            done.push_back(pool.submit([&sum, i]() { sum += i; }));
+        }
+        for (auto& task : done) {
+            task.get();
+        }
+        EXPECT_EQ(sum, 5050);
+    }
+}
+
+TEST(ThreadPoolTest, FinishesQueuedTasksOnDestruction) {
+    std::atomic<int> count(0);
+    {
+        ThreadPool pool(1);
+        for (int i = 0; i < 10; ++i) {
+            pool.submit([&count]() { count++; });
+        }
+    }
+    EXPECT_EQ(count, 10);
+}
@@ -0,0 +1,55 @@
+#include "uci_io.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+TEST(UciIoTest, TokenizesWithoutCopying) {
+    std::string line = "  position startpos\tmoves e2e4  e7e5\r\n";
+    UciTokenizer tokens(line);
+    std::string_view first = tokens.next();
+    EXPECT_EQ(first, "position");
+    EXPECT_EQ(first.data(), line.data() + 2);
+    EXPECT_EQ(tokens.next(), "startpos");
+    EXPECT_EQ(tokens.next(), "moves");
+    EXPECT_EQ(tokens.next(), "e2e4");
+    EXPECT_FALSE(tokens.empty());
+    EXPECT_EQ(tokens.next(), "e7e5");
+    EXPECT_TRUE(tokens.empty());
+    EXPECT_TRUE(tokens.next().empty());
+}
+
+TEST(UciIoTest, ParsesNumbersAndRest) {
+    UciTokenizer tokens("wtime 300000 depth x12 nodes -5 value  My Book.bin ");
+    int64_t time = 0;
+    int depth = 7;
+    uint64_t nodes = 3;
+    EXPECT_EQ(tokens.next(), "wtime");
+    EXPECT_TRUE(tokens.next(time));
+    EXPECT_EQ(time, 300000);
+    EXPECT_EQ(tokens.next(), "depth");
+    EXPECT_FALSE(tokens.next(depth));
+    EXPECT_EQ(depth, 7);
+    EXPECT_EQ(tokens.next(), "nodes");
+    EXPECT_FALSE(tokens.next(nodes));
+    EXPECT_EQ(nodes, 3u);
+    EXPECT_EQ(tokens.next(), "value");
+    EXPECT_EQ(tokens.rest(), "My Book.bin");
+    EXPECT_TRUE(tokens.empty());
+}
+
+TEST(UciIoTest, WriterFlushesOncePerResponse) {
+    std::ostringstream out;
+    UciWriter writer(out);
+    writer << "info depth " << 12 << " score cp " << -35 << " pv " << Move(E2, E4) << ' '
+           << Move(A7, A8, QUEEN) << '\n';
+    writer << "info string ebf ";
+    writer.fixed(2.456, 2) << '\n';
+    EXPECT_TRUE(out.str().empty());
+
+    writer.flush();
+    EXPECT_EQ(out.str(), "info depth 12 score cp -35 pv e2e4 a7a8q\ninfo string ebf 2.46\n");
+    EXPECT_TRUE(writer.pending().empty());
+
+    writer << "bestmove " << Move() << '\n';
+    writer.flush();
+    EXPECT_EQ(out.str().substr(out.str().rfind("bestmove")), "bestmove 0000\n");
+}